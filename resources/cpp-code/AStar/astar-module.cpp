@@ -0,0 +1,228 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grid-graph.hpp"
+#include "search-core.hpp"
+
+namespace py = pybind11;
+
+// Calls f with a GridView over the NumPy buffer itself, whatever its
+// signed integer or floating dtype and its strides. Nothing is copied.
+template <class F>
+void with_grid_view(const py::buffer_info& info, char kind, F&& f) {
+    if (info.ndim != 2) {
+        throw std::invalid_argument("map_grid must be a 2-D array");
+    }
+    if (info.strides[0] % info.itemsize != 0 || info.strides[1] % info.itemsize != 0) {
+        throw std::invalid_argument("map_grid strides must be a multiple of its item size");
+    }
+    int rows = static_cast<int>(info.shape[0]);
+    int cols = static_cast<int>(info.shape[1]);
+    long row_stride = static_cast<long>(info.strides[0] / info.itemsize);
+    long col_stride = static_cast<long>(info.strides[1] / info.itemsize);
+
+    auto run = [&](auto* cells) {
+        using Cell = std::remove_const_t<std::remove_pointer_t<decltype(cells)>>;
+        f(GridView<Cell>(cells, rows, cols, row_stride, col_stride));
+    };
+    if (kind == 'i') {
+        switch (info.itemsize) {
+        case 1: return run(static_cast<const std::int8_t*>(info.ptr));
+        case 2: return run(static_cast<const std::int16_t*>(info.ptr));
+        case 4: return run(static_cast<const std::int32_t*>(info.ptr));
+        case 8: return run(static_cast<const std::int64_t*>(info.ptr));
+        }
+    } else if (kind == 'f') {
+        switch (info.itemsize) {
+        case 4: return run(static_cast<const float*>(info.ptr));
+        case 8: return run(static_cast<const double*>(info.ptr));
+        }
+    }
+    throw std::invalid_argument("map_grid must hold signed integers or floats");
+}
+
+// Accepts the reference implementation's Node (with .pos), a DataPoint-like
+// object (with .coordinates) or a plain (row, col) pair.
+std::pair<int, int> cell_of(const py::handle& node) {
+    py::object pos;
+    if (py::hasattr(node, "pos")) {
+        pos = node.attr("pos");
+    } else if (py::hasattr(node, "coordinates")) {
+        pos = node.attr("coordinates");
+    } else {
+        pos = py::reinterpret_borrow<py::object>(node);
+    }
+    py::sequence sequence = pos.cast<py::sequence>();
+    if (py::len(sequence) != 2) {
+        throw std::invalid_argument("a position must have two coordinates");
+    }
+    return {sequence[0].cast<int>(), sequence[1].cast<int>()};
+}
+
+template <class View>
+bool open_cell(const View& view, std::pair<int, int> cell) {
+    return cell.first >= 0 && cell.first < view.row_count() && cell.second >= 0 && cell.second < view.column_count() &&
+           view.passable(view.node(cell.first, cell.second));
+}
+
+// Same call shape as AStar.py: AStar(map_grid, start_node, goal_node).search()
+// returns (path, cost) with path a list of (row, col) tuples, or None.
+class PyAStar {
+private:
+    py::array map_grid;
+    std::pair<int, int> start;
+    std::pair<int, int> goal;
+
+public:
+    PyAStar(py::array map_grid_, const py::object& start_node, const py::object& goal_node)
+        : map_grid(std::move(map_grid_)), start(cell_of(start_node)), goal(cell_of(goal_node)) {}
+
+    py::object search() {
+        py::buffer_info info = map_grid.request();
+        SearchResult result;
+        std::vector<std::pair<int, int>> path;
+        with_grid_view(info, map_grid.dtype().kind(), [&](const auto& view) {
+            if (!open_cell(view, start) || !open_cell(view, goal)) {
+                throw py::index_error("start or goal is outside the grid or on a wall");
+            }
+            {
+                py::gil_scoped_release release;
+                SearchCore<std::decay_t<decltype(view)>> core(view);
+                result = core.execute(view.node(start.first, start.second), view.node(goal.first, goal.second));
+                path.reserve(result.path.size());
+                for (int node : result.path) {
+                    path.push_back(view.coordinates(node));
+                }
+            }
+        });
+        if (!result.found) {
+            return py::none();
+        }
+        py::list cells;
+        for (const auto& p : path) {
+            cells.append(py::make_tuple(p.first, p.second));
+        }
+        return py::make_tuple(cells, result.cost);
+    }
+};
+
+// Solves N queries given as (N, 2) start and goal arrays on `threads`
+// threads. Returns (paths, offsets, costs): all paths concatenated into
+// one (M, 2) int32 array, the N + 1 offsets of each query's slice, and
+// the N costs with NaN where no path exists. An exception in any worker
+// stops the others and is rethrown here once they have all joined.
+py::tuple search_batch(const py::array& map_grid,
+                       const py::array_t<std::int32_t, py::array::c_style | py::array::forcecast>& starts,
+                       const py::array_t<std::int32_t, py::array::c_style | py::array::forcecast>& goals,
+                       int threads) {
+    if (starts.ndim() != 2 || starts.shape(1) != 2 || goals.ndim() != 2 || goals.shape(1) != 2 ||
+        starts.shape(0) != goals.shape(0)) {
+        throw std::invalid_argument("starts and goals must both have shape (N, 2)");
+    }
+    const std::size_t count = static_cast<std::size_t>(starts.shape(0));
+    const std::int32_t* start_cells = starts.data();
+    const std::int32_t* goal_cells = goals.data();
+    py::buffer_info info = map_grid.request();
+
+    std::vector<std::vector<std::int32_t>> paths(count);
+    std::vector<double> costs(count, std::numeric_limits<double>::quiet_NaN());
+    std::mutex error_lock;
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    with_grid_view(info, map_grid.dtype().kind(), [&](const auto& view) {
+        using View = std::decay_t<decltype(view)>;
+        py::gil_scoped_release release;
+        auto solve = [&](std::size_t first, std::size_t step) {
+            SearchCore<View> core(view);
+            for (std::size_t i = first; i < count && !failed.load(std::memory_order_relaxed); i += step) {
+                std::pair<int, int> start(start_cells[2 * i], start_cells[2 * i + 1]);
+                std::pair<int, int> goal(goal_cells[2 * i], goal_cells[2 * i + 1]);
+                if (!open_cell(view, start) || !open_cell(view, goal)) {
+                    continue;
+                }
+                SearchResult result = core.execute(view.node(start.first, start.second), view.node(goal.first, goal.second));
+                if (!result.found) {
+                    continue;
+                }
+                costs[i] = result.cost;
+                paths[i].reserve(2 * result.path.size());
+                for (int node : result.path) {
+                    auto p = view.coordinates(node);
+                    paths[i].push_back(p.first);
+                    paths[i].push_back(p.second);
+                }
+            }
+        };
+        auto work = [&](std::size_t first, std::size_t step) {
+            try {
+                solve(first, step);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+        std::size_t workers = static_cast<std::size_t>(std::max(1, threads));
+        std::vector<std::thread> pool;
+        std::size_t started = 1;
+        try {
+            for (; started < workers; started++) {
+                pool.emplace_back(work, started, workers);
+            }
+        } catch (const std::exception&) {
+            // Fewer threads than asked for: the calling thread takes the
+            // strides of the ones that could not start.
+        }
+        for (std::size_t t = started; t < workers; t++) {
+            work(t, workers);
+        }
+        work(0, workers);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    py::array_t<std::int64_t> offsets(static_cast<py::ssize_t>(count + 1));
+    auto offset = offsets.mutable_unchecked<1>();
+    offset(0) = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        offset(i + 1) = offset(i) + static_cast<std::int64_t>(paths[i].size() / 2);
+    }
+    py::array_t<std::int32_t> cells({static_cast<py::ssize_t>(offset(count)), static_cast<py::ssize_t>(2)});
+    std::int32_t* out = cells.mutable_data();
+    for (const auto& path : paths) {
+        out = std::copy(path.begin(), path.end(), out);
+    }
+    py::array_t<double> cost_array(static_cast<py::ssize_t>(count));
+    std::copy(costs.begin(), costs.end(), cost_array.mutable_data());
+    return py::make_tuple(cells, offsets, cost_array);
+}
+
+PYBIND11_MODULE(astar_engine, m) {
+    m.doc() = "C++ A* search over NumPy map grids (costs per cell, -1 for walls)";
+
+    py::class_<PyAStar>(m, "AStar")
+        .def(py::init<py::array, const py::object&, const py::object&>(),
+             py::arg("map_grid"), py::arg("start_node"), py::arg("goal_node"))
+        .def("search", &PyAStar::search);
+
+    m.def("search_batch", &search_batch,
+          py::arg("map_grid"), py::arg("starts"), py::arg("goals"), py::arg("threads") = 1);
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#if defined(ASTAR_WITH_LIBNUMA)
+#include <numa.h>
+#endif
+
+#include "search-core.hpp"
+
+// CPUs of each memory node that has any. Built from libnuma when compiled
+// with ASTAR_WITH_LIBNUMA (and linked with -lnuma), otherwise from sysfs.
+// Nodes are indexed densely, but each keeps its kernel node id, which is
+// what the memory-policy calls take: online nodes can be sparse ("0,2")
+// and memory-only nodes (CXL, HBM) are skipped. A machine without NUMA
+// information is treated as one node, with id -1, holding every CPU this
+// process may run on.
+class NumaTopology {
+private:
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+    };
+
+    std::vector<Node> nodes;
+
+    static std::vector<int> parse_cpu_list(const std::string& text) {
+        std::vector<int> cpus;
+        std::stringstream stream(text);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            if (range.empty() || range == "\n") {
+                continue;
+            }
+            auto dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+public:
+    static NumaTopology detect() {
+        NumaTopology topology;
+#if defined(ASTAR_WITH_LIBNUMA)
+        if (numa_available() != -1) {
+            struct bitmask* cpus = numa_allocate_cpumask();
+            for (int node = 0; node <= numa_max_node(); node++) {
+                std::vector<int> list;
+                if (numa_node_to_cpus(node, cpus) == 0) {
+                    for (unsigned cpu = 0; cpu < cpus->size; cpu++) {
+                        if (numa_bitmask_isbitset(cpus, cpu)) {
+                            list.push_back(static_cast<int>(cpu));
+                        }
+                    }
+                }
+                if (!list.empty()) {
+                    topology.nodes.push_back({node, std::move(list)});
+                }
+            }
+            numa_free_cpumask(cpus);
+        }
+#else
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string online_nodes;
+        if (online && std::getline(online, online_nodes)) {
+            for (int node : parse_cpu_list(online_nodes)) {
+                std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string cpus;
+                if (cpulist && std::getline(cpulist, cpus)) {
+                    auto list = parse_cpu_list(cpus);
+                    if (!list.empty()) {
+                        topology.nodes.push_back({node, std::move(list)});
+                    }
+                }
+            }
+        }
+#endif
+        if (topology.nodes.empty()) {
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            std::vector<int> list;
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                    if (CPU_ISSET(cpu, &allowed)) {
+                        list.push_back(cpu);
+                    }
+                }
+            }
+            if (list.empty()) {
+                list.push_back(0);
+            }
+            topology.nodes.push_back({-1, std::move(list)});
+        }
+        return topology;
+    }
+
+    int node_count() const {
+        return static_cast<int>(nodes.size());
+    }
+
+    // Kernel node id of the index-th node, or -1 when unknown.
+    int node_id(int index) const {
+        return nodes[index].id;
+    }
+
+    const std::vector<int>& cpus(int index) const {
+        return nodes[index].cpus;
+    }
+};
+
+// Pins the calling thread to the CPUs of the index-th node and makes that
+// node its preferred memory node, so everything the thread allocates and
+// first touches afterwards (grid replicas, search scratch) is node local.
+// Returns false if either step failed; the thread then keeps whatever
+// placement it could get.
+inline bool bind_thread_to_node(const NumaTopology& topology, int index) {
+    const int node = topology.node_id(index);
+#if defined(ASTAR_WITH_LIBNUMA)
+    if (numa_available() != -1 && node >= 0) {
+        if (numa_run_on_node(node) != 0) {
+            return false;
+        }
+        numa_set_preferred(node);
+        return true;
+    }
+#endif
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : topology.cpus(index)) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        return false;
+    }
+    if (node < 0) {
+        return true;
+    }
+#if defined(SYS_set_mempolicy)
+    const int MPOL_PREFERRED_MODE = 1;
+    const int word_bits = static_cast<int>(sizeof(unsigned long) * 8);
+    unsigned long mask[16] = {0};
+    if (node >= static_cast<int>(sizeof(mask) * 8)) {
+        return false;
+    }
+    mask[node / word_bits] |= 1UL << (node % word_bits);
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, mask, sizeof(mask) * 8 + 1) == 0;
+#else
+    return false;
+#endif
+}
+
+struct BatchOptions {
+    int threads = 1;
+    bool numa_aware = false;
+    int chunk = 64;
+    // When set, receives the number of builder and worker threads that
+    // could not be bound to their node and ran with default placement.
+    std::atomic<int>* unbound_threads = nullptr;
+};
+
+// Solves (start, goal) node pairs on a pool of worker threads. build_graph
+// is called once in shared mode, or once per memory node in NUMA-aware mode
+// from a thread bound to that node; workers are spread round-robin over the
+// nodes, bound to them, and search only their node's replica. A thread that
+// cannot be bound still does its work, only without node-local memory.
+template <class Graph, class Build>
+std::vector<SearchResult> run_batch(Build&& build_graph, const std::vector<std::pair<int, int>>& queries,
+                                    const BatchOptions& options) {
+    if (options.threads < 1 || options.chunk < 1) {
+        throw std::invalid_argument("run_batch: threads and chunk must be at least 1");
+    }
+    std::vector<SearchResult> results(queries.size());
+    NumaTopology topology = NumaTopology::detect();
+    int nodes = options.numa_aware ? topology.node_count() : 1;
+
+    std::vector<std::unique_ptr<Graph>> replicas(nodes);
+    if (options.numa_aware) {
+        std::vector<std::thread> builders;
+        for (int node = 0; node < nodes; node++) {
+            builders.emplace_back([&, node]() {
+                if (!bind_thread_to_node(topology, node) && options.unbound_threads) {
+                    options.unbound_threads->fetch_add(1);
+                }
+                replicas[node] = std::make_unique<Graph>(build_graph());
+            });
+        }
+        for (auto& builder : builders) {
+            builder.join();
+        }
+    } else {
+        replicas[0] = std::make_unique<Graph>(build_graph());
+    }
+
+    std::atomic<std::size_t> next_query(0);
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < options.threads; worker++) {
+        workers.emplace_back([&, worker]() {
+            int node = worker % nodes;
+            if (options.numa_aware && !bind_thread_to_node(topology, node) && options.unbound_threads) {
+                options.unbound_threads->fetch_add(1);
+            }
+            SearchCore<Graph> search(*replicas[node]);
+            while (true) {
+                std::size_t begin = next_query.fetch_add(options.chunk);
+                if (begin >= queries.size()) {
+                    break;
+                }
+                std::size_t end = std::min(queries.size(), begin + static_cast<std::size_t>(options.chunk));
+                for (std::size_t i = begin; i < end; i++) {
+                    results[i] = search.execute(queries[i].first, queries[i].second);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
@@ -0,0 +1,795 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <utility>
+#include <atomic>
+#include <thread>
+
+#include "batch-workers.hpp"
+#include "compact-grid-graph.hpp"
+#include "delta-stepping.hpp"
+#include "goal-bounding.hpp"
+#include "goal-field-cache.hpp"
+#include "grid-graph.hpp"
+#include "grid-pyramid.hpp"
+#include "map-generators.hpp"
+#include "map-io.hpp"
+#include "nearest-goal-field.hpp"
+#include "octile-grid-graph.hpp"
+#include "open-list.hpp"
+#include "perf-counters.hpp"
+#include "rectangle-symmetry.hpp"
+#include "region-pruning.hpp"
+#include "search-core.hpp"
+#include "simd-grid-search.hpp"
+#include "versioned-grid.hpp"
+#include "zorder-grid-graph.hpp"
+
+// Seeded weighted grid with costs 0-8 and the given fraction of -1 walls.
+inline std::vector<std::vector<int>> random_grid(int rows, int cols, double wall_ratio, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::vector<int>> data_matrix(rows, std::vector<int>(cols));
+    for (auto& row : data_matrix) {
+        for (int& cell : row) {
+            cell = generator_unit(rng) < wall_ratio ? -1 : generator_below(rng, 9);
+        }
+    }
+    return data_matrix;
+}
+
+// Random passable (start, goal) cell pairs, as (row, col) coordinates.
+inline std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> random_queries(
+        const std::vector<std::vector<int>>& data_matrix, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    const int rows = static_cast<int>(data_matrix.size());
+    const int cols = static_cast<int>(data_matrix[0].size());
+    auto passable_cell = [&]() {
+        while (true) {
+            int r = generator_below(rng, rows);
+            int c = generator_below(rng, cols);
+            if (data_matrix[r][c] != -1) {
+                return std::make_pair(r, c);
+            }
+        }
+    };
+    std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+    queries.reserve(count);
+    for (int i = 0; i < count; i++) {
+        auto start = passable_cell();
+        queries.emplace_back(start, passable_cell());
+    }
+    return queries;
+}
+
+struct BenchmarkTotals {
+    double seconds = 0.0;
+    double cost = 0.0;
+    std::size_t expanded = 0;
+    int found = 0;
+    bool has_perf = false;
+    PerfTotals perf;
+};
+
+// Hardware counter instrumentation of run_queries(): 0 leaves it off,
+// otherwise phases are timed on one pop in this many. Set by the
+// driver's --perf[=N] flag. Wall times measured with it on include the
+// probe's read() calls.
+inline std::uint32_t& benchmark_perf_period() {
+    static std::uint32_t period = 0;
+    return period;
+}
+
+// Adds one query's expansions, and its cost when a path was found.
+inline void add_result(BenchmarkTotals& totals, const SearchResult& result) {
+    totals.expanded += result.expanded;
+    if (result.found) {
+        totals.found++;
+        totals.cost += result.cost;
+    }
+}
+
+// Times solve(initial, target) on the graph's nodes for each query and
+// adds up the SearchResults it returns.
+template <class Graph, class Solve>
+BenchmarkTotals run_queries_by(const Graph& graph,
+                               const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>& queries,
+                               Solve&& solve) {
+    BenchmarkTotals totals;
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& q : queries) {
+        add_result(totals, solve(graph.node(q.first.first, q.first.second), graph.node(q.second.first, q.second.second)));
+    }
+    totals.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return totals;
+}
+
+template <class Graph, class OpenList, class Probe>
+BenchmarkTotals run_queries_with(SearchCore<Graph, OpenList, Probe>& search, const Graph& graph,
+                                 const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>& queries) {
+    return run_queries_by(graph, queries, [&](int initial, int target) { return search.execute(initial, target); });
+}
+
+template <class Graph, class OpenList = BinaryOpenList>
+BenchmarkTotals run_queries(const Graph& graph,
+                            const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>& queries) {
+    if (benchmark_perf_period() == 0) {
+        SearchCore<Graph, OpenList> search(graph);
+        return run_queries_with(search, graph, queries);
+    }
+    SearchCore<Graph, OpenList, PerfPhaseProbe> search(graph);
+    search.probe().set_sample_period(benchmark_perf_period());
+    BenchmarkTotals totals = run_queries_with(search, graph, queries);
+    totals.has_perf = true;
+    totals.perf = search.probe().totals();
+    return totals;
+}
+
+// One line per phase and one for whole searches: the counters, IPC and
+// misses per thousand instructions; "-" for counters the machine lacks.
+inline void print_perf_totals(const PerfTotals& perf) {
+    auto print_row = [&](const char* name, const PerfSample& sample) {
+        std::cout << "  " << name << ":";
+        const char* labels[PERF_COUNTER_COUNT] = {"cycles", "instructions", "cache misses", "branch misses", "task ns"};
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            std::cout << " " << labels[i] << " ";
+            if (perf.available[i]) {
+                std::cout << sample.value[i];
+            } else {
+                std::cout << "-";
+            }
+        }
+        double instructions = static_cast<double>(sample.value[PERF_INSTRUCTIONS]);
+        if (perf.available[PERF_CYCLES] && perf.available[PERF_INSTRUCTIONS] && sample.value[PERF_CYCLES] > 0) {
+            std::cout << ", IPC " << instructions / sample.value[PERF_CYCLES];
+        }
+        if (perf.available[PERF_INSTRUCTIONS] && instructions > 0) {
+            if (perf.available[PERF_CACHE_MISSES]) {
+                std::cout << ", cache MPKI " << sample.value[PERF_CACHE_MISSES] * 1e3 / instructions;
+            }
+            if (perf.available[PERF_BRANCH_MISSES]) {
+                std::cout << ", branch MPKI " << sample.value[PERF_BRANCH_MISSES] * 1e3 / instructions;
+            }
+        }
+        std::cout << std::endl;
+    };
+    std::cout << "  perf: " << perf.searches << " searches, phases sampled on " << perf.sampled_pops
+              << " pops" << std::endl;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        print_row(phase_name(p), perf.phase[p]);
+    }
+    print_row("search", perf.search);
+}
+
+inline void print_totals(const char* name, const BenchmarkTotals& totals, std::size_t queries) {
+    std::cout << name << ": " << totals.seconds * 1e3 << " ms, "
+              << totals.seconds * 1e6 / queries << " us/query, "
+              << totals.expanded / queries << " expansions/query, "
+              << totals.found << " found, total cost " << totals.cost << std::endl;
+    if (totals.has_perf) {
+        print_perf_totals(totals.perf);
+    }
+}
+
+// Row-major against Z-order tiled layout and the compact 8-bit encoding
+// on one large map and query set.
+inline void run_layout_benchmark(int size, int query_count) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    std::cout << "Layout benchmark: " << size << "x" << size << ", " << query_count << " queries" << std::endl;
+
+    GridGraph row_major(data_matrix);
+    print_totals("row-major", run_queries(row_major, queries), queries.size());
+
+    CompactGridGraph compact(data_matrix);
+    std::cout << "compact map: " << compact.memory_bytes() << " bytes, row-major "
+              << static_cast<std::size_t>(row_major.node_count()) * sizeof(int) << " bytes" << std::endl;
+    print_totals("compact 8-bit", run_queries(compact, queries), queries.size());
+
+    for (int tile_shift : {3, 4, 5}) {
+        ZOrderGridGraph zorder(data_matrix, tile_shift);
+        std::string name = "z-order " + std::to_string(1 << tile_shift) + "x" + std::to_string(1 << tile_shift);
+        print_totals(name.c_str(), run_queries(zorder, queries), queries.size());
+    }
+}
+
+// The open-list policies of SearchCore on one map and query set.
+inline void run_open_list_benchmark(int size, int query_count) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    std::cout << "Open list benchmark: " << size << "x" << size << ", " << query_count << " queries" << std::endl;
+
+    GridGraph grid(data_matrix);
+    print_totals("binary", run_queries<GridGraph, BinaryOpenList>(grid, queries), queries.size());
+    print_totals("4-ary", run_queries<GridGraph, QuaternaryOpenList>(grid, queries), queries.size());
+    print_totals("8-ary", run_queries<GridGraph, OctonaryOpenList>(grid, queries), queries.size());
+    print_totals("pairing", run_queries<GridGraph, PairingOpenList>(grid, queries), queries.size());
+}
+
+// Full-resolution search against coarse-to-fine pyramids of growing depth.
+// Peak nodes is the largest graph a query had to size its search arrays
+// for, averaged over the queries.
+inline void run_pyramid_benchmark(int size, int query_count) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    std::cout << "Pyramid benchmark: " << size << "x" << size << ", " << query_count << " queries" << std::endl;
+
+    GridGraph grid(data_matrix);
+    BenchmarkTotals full = run_queries(grid, queries);
+    print_totals("full", full, queries.size());
+    std::cout << "  peak nodes " << grid.node_count() << std::endl;
+
+    for (int levels : {3, 5, 7}) {
+        GridPyramid pyramid(data_matrix, levels);
+        std::size_t peak_nodes = 0;
+        int widenings = 0;
+        BenchmarkTotals totals = run_queries_by(grid, queries, [&](int initial, int target) {
+            PyramidResult result = pyramid_search(pyramid, grid.coordinates(initial), grid.coordinates(target));
+            peak_nodes += result.peak_nodes;
+            widenings += result.widenings;
+            return result;
+        });
+        std::string name = std::to_string(levels) + " levels";
+        print_totals(name.c_str(), totals, queries.size());
+        std::cout << "  peak nodes " << peak_nodes / queries.size() << ", " << widenings << " widenings, cost "
+                  << totals.cost / full.cost << "x full" << std::endl;
+    }
+}
+
+// Serial Dijkstra against parallel delta-stepping for one source and the
+// whole map, checking that both produce the same distance field.
+inline void run_sssp_benchmark(int size, int threads) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    GridGraph grid(data_matrix);
+    auto depot = random_queries(data_matrix, 1, 7)[0].first;
+    int source = grid.node(depot.first, depot.second);
+    std::cout << "SSSP benchmark: " << size << "x" << size << ", " << threads << " threads" << std::endl;
+
+    auto begin = std::chrono::steady_clock::now();
+    DistanceField reference = dijkstra_field(grid, source);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "dijkstra: " << seconds * 1e3 << " ms" << std::endl;
+
+    for (float delta : {2.0f, 8.0f}) {
+        for (int team : {1, threads}) {
+            begin = std::chrono::steady_clock::now();
+            DistanceField field = delta_stepping(grid, source, delta, team);
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::size_t mismatches = 0;
+            for (std::size_t node = 0; node < field.distance.size(); node++) {
+                if (field.distance[node] != reference.distance[node]) {
+                    mismatches++;
+                }
+            }
+            std::cout << "delta-stepping delta " << delta << ", " << team << " threads: " << seconds * 1e3
+                      << " ms, " << mismatches << " mismatches" << std::endl;
+        }
+    }
+}
+
+// Plain search against goal-bounded search, after timing the parallel
+// preprocessing. Expansions show what is pruned. Total costs can differ a
+// little: across 0-cost cells Manhattan overestimates, so neither search
+// is exactly optimal and the pruning changes which path each one finds.
+inline void run_goal_bounding_benchmark(int size, int query_count, int threads) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    std::cout << "Goal bounding benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+              << threads << " threads" << std::endl;
+
+    GridGraph grid(data_matrix);
+    auto begin = std::chrono::steady_clock::now();
+    GoalBounds bounds(grid, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "preprocessing: " << seconds * 1e3 << " ms" << std::endl;
+
+    print_totals("plain", run_queries(grid, queries), queries.size());
+
+    GoalBoundedSearch search(grid, bounds);
+    BenchmarkTotals totals =
+        run_queries_by(grid, queries, [&](int initial, int target) { return search.execute(initial, target); });
+    print_totals("goal-bounded", totals, queries.size());
+}
+
+// Plain search against search with dead ends and swamps pruned. Queries
+// start and end anywhere, so some of them sit inside a pruned region.
+inline void run_region_pruning_benchmark(int size, int query_count, int max_swamp_region) {
+    auto data_matrix = random_grid(size, size, 0.3, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    std::cout << "Region pruning benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+              << "swamps up to " << max_swamp_region << " cells" << std::endl;
+
+    GridGraph grid(data_matrix);
+    auto begin = std::chrono::steady_clock::now();
+    RegionPruning pruning(grid, max_swamp_region);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "preprocessing: " << seconds * 1e3 << " ms, " << pruning.articulation_count()
+              << " articulation cells, " << pruning.swamp_count() << " swamps" << std::endl;
+
+    print_totals("plain", run_queries(grid, queries), queries.size());
+
+    PrunedSearch search(pruning);
+    BenchmarkTotals totals =
+        run_queries_by(grid, queries, [&](int initial, int target) { return search.execute(initial, target); });
+    print_totals("pruned", totals, queries.size());
+}
+
+// Readers searching pinned snapshots while one writer keeps toggling
+// walls, 16 cells per published version.
+inline void run_versioned_grid_benchmark(int size, int query_count, int threads) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    threads = std::max(1, threads);
+    std::cout << "Versioned grid benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+              << threads << " reader(s)" << std::endl;
+
+    VersionedGrid grid(data_matrix, threads);
+    std::atomic<int> next_query(0);
+    std::atomic<bool> readers_done(false);
+    std::vector<BenchmarkTotals> per_reader(threads);
+    std::size_t published = 0;
+    double update_seconds = 0.0;
+
+    std::thread writer([&]() {
+        std::mt19937 generator(99);
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        std::uniform_int_distribution<int> cost(-1, 8);
+        while (!readers_done.load(std::memory_order_acquire)) {
+            std::vector<CellUpdate> updates;
+            for (int i = 0; i < 16; i++) {
+                updates.push_back({cell(generator), cell(generator), cost(generator)});
+            }
+            auto begin = std::chrono::steady_clock::now();
+            grid.update(updates);
+            update_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            published++;
+            std::this_thread::yield();
+        }
+    });
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < threads; reader++) {
+        readers.emplace_back([&, reader]() {
+            SnapshotGraph graph(grid.pin(reader).snapshot());
+            SearchCore<SnapshotGraph> search(graph);
+            BenchmarkTotals& totals = per_reader[reader];
+            for (int q = next_query++; q < query_count; q = next_query++) {
+                auto pin = grid.pin(reader);
+                const GridSnapshot& snapshot = pin.snapshot();
+                graph.set_snapshot(snapshot);
+                const auto& query = queries[q];
+                int initial = snapshot.node(query.first.first, query.first.second);
+                int target = snapshot.node(query.second.first, query.second.second);
+                if (!snapshot.passable(initial) || !snapshot.passable(target)) {
+                    continue;
+                }
+                SearchResult result = search.execute(initial, target);
+                totals.expanded += result.expanded;
+                if (result.found) {
+                    totals.found++;
+                    totals.cost += result.cost;
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    readers_done.store(true, std::memory_order_release);
+    writer.join();
+
+    BenchmarkTotals totals;
+    totals.seconds = seconds;
+    for (const auto& reader : per_reader) {
+        totals.expanded += reader.expanded;
+        totals.found += reader.found;
+        totals.cost += reader.cost;
+    }
+    print_totals("pinned snapshots", totals, queries.size());
+    std::size_t waiting = grid.retired_count();
+    grid.reclaim();
+    std::cout << "versions published: " << published << ", "
+              << (published > 0 ? update_seconds * 1e6 / published : 0.0) << " us/update, "
+              << waiting << " retired version(s) still pinned at the end, "
+              << grid.retired_count() << " after a final reclaim" << std::endl;
+}
+
+// Nearest of `goal_count` goals: one search per goal against one
+// multi-goal search, with the minimum-over-goals heuristic and with a
+// precomputed NearestGoalField. Each query draws its own goal set.
+inline void run_multi_goal_benchmark(int size, int query_count, int goal_count) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count * goal_count, 7);
+    std::cout << "Multi-goal benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+              << goal_count << " goals each" << std::endl;
+
+    GridGraph grid(data_matrix);
+    SearchCore<GridGraph> search(grid);
+    auto goals_of = [&](int q) {
+        std::vector<int> goals;
+        for (int k = 0; k < goal_count; k++) {
+            const auto& goal = queries[q * goal_count + k].second;
+            goals.push_back(grid.node(goal.first, goal.second));
+        }
+        return goals;
+    };
+    auto start_of = [&](int q) {
+        return grid.node(queries[q * goal_count].first.first, queries[q * goal_count].first.second);
+    };
+
+    BenchmarkTotals separate;
+    auto begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < query_count; q++) {
+        SearchResult nearest;
+        for (int goal : goals_of(q)) {
+            SearchResult result = search.solve(start_of(q), goal);
+            separate.expanded += result.expanded;
+            if (result.found && (!nearest.found || result.cost < nearest.cost)) {
+                nearest = result;
+            }
+        }
+        nearest.expanded = 0;
+        add_result(separate, nearest);
+    }
+    separate.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    print_totals("one search per goal", separate, query_count);
+
+    BenchmarkTotals combined;
+    begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < query_count; q++) {
+        add_result(combined, search.solve_nearest(start_of(q), goals_of(q)));
+    }
+    combined.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    print_totals("multi-goal, min heuristic", combined, query_count);
+
+    BenchmarkTotals field;
+    begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < query_count; q++) {
+        std::vector<int> goals = goals_of(q);
+        NearestGoalField nearest(grid, goals);
+        add_result(field, search.solve_nearest(start_of(q), goals, [&](int node) { return nearest.heuristic(node); }));
+    }
+    field.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    print_totals("multi-goal, goal field", field, query_count);
+}
+
+// Many starts heading for a few popular goals (goal k drawn with weight
+// 1 / (k + 1)), searched one by one and answered from a GoalFieldCache
+// with room for `cached_goals` fields, under LRU and LFU. Halfway through
+// the grid version is bumped, so cached fields are rebuilt once.
+inline void run_goal_cache_benchmark(int size, int query_count, int goal_count, int cached_goals) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count + goal_count, 7);
+    std::cout << "Goal cache benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+              << goal_count << " goals, room for " << cached_goals << " fields" << std::endl;
+
+    GridGraph grid(data_matrix);
+    std::vector<int> goals;
+    std::vector<double> weights;
+    for (int k = 0; k < goal_count; k++) {
+        goals.push_back(grid.node(queries[query_count + k].second.first, queries[query_count + k].second.second));
+        weights.push_back(1.0 / (k + 1));
+    }
+    std::mt19937 generator(11);
+    std::discrete_distribution<int> popular(weights.begin(), weights.end());
+    std::vector<std::pair<int, int>> routes;
+    for (int q = 0; q < query_count; q++) {
+        routes.emplace_back(grid.node(queries[q].first.first, queries[q].first.second), goals[popular(generator)]);
+    }
+
+    BenchmarkTotals searched;
+    SearchCore<GridGraph> search(grid);
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& route : routes) {
+        add_result(searched, search.execute(route.first, route.second));
+    }
+    searched.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    print_totals("search per query", searched, routes.size());
+
+    for (FieldEviction policy : {FieldEviction::LRU, FieldEviction::LFU}) {
+        std::size_t field_bytes = static_cast<std::size_t>(grid.node_count()) * (sizeof(float) + sizeof(std::int8_t));
+        GoalFieldCache cache(field_bytes * cached_goals, policy);
+        BenchmarkTotals cached;
+        begin = std::chrono::steady_clock::now();
+        for (std::size_t q = 0; q < routes.size(); q++) {
+            std::uint64_t version = q < routes.size() / 2 ? 1 : 2;
+            add_result(cached, cache.route(grid, version, routes[q].first, routes[q].second));
+        }
+        cached.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        print_totals(policy == FieldEviction::LRU ? "field cache, LRU" : "field cache, LFU", cached, routes.size());
+        const auto& stats = cache.stats();
+        std::cout << "  " << stats.hits << " hits, " << stats.misses << " misses (" << stats.rebuilds
+                  << " for a new version), " << stats.evictions << " evictions, " << cache.memory_bytes()
+                  << " bytes held" << std::endl;
+    }
+}
+
+// SearchCore on each seeded generator's map at the same size and seeds, so
+// runs on different machines or commits see identical workloads.
+inline void run_map_suite_benchmark(int size, int query_count) {
+    std::cout << "Map suite: " << size << "x" << size << ", " << query_count << " queries per map" << std::endl;
+    const std::pair<const char*, std::vector<std::vector<int>>> maps[] = {
+        {"maze", maze_grid(size, size, 42)},
+        {"maze, 4-wide corridors", maze_grid(size, size, 42, 4)},
+        {"rooms", rooms_grid(size, size, 16, 42)},
+        {"noise terrain", noise_terrain_grid(size, size, 42)},
+        {"open field", open_field_grid(size, size, 42)},
+        {"uniform random", random_grid(size, size, 0.2, 42)},
+    };
+    for (const auto& named : maps) {
+        GridGraph grid(named.second);
+        auto queries = random_queries(named.second, query_count, 7);
+        print_totals(named.first, run_queries(grid, queries), queries.size());
+    }
+}
+
+// Runs a MovingAI .scen file. Each map is searched twice per query:
+// 8-connected with OctileGridGraph, whose cost is checked against the
+// scenario's optimal length, and 4-connected with GridGraph, the engine's
+// own movement model, whose costs are necessarily higher. Map names are
+// looked up as written, then next to the .scen file. limit > 0 keeps the
+// first `limit` queries.
+inline int run_scenario_benchmark(const std::string& path, std::size_t limit) {
+    std::vector<ScenarioQuery> scenario = load_movingai_scenario(path);
+    if (limit > 0 && scenario.size() > limit) {
+        scenario.resize(limit);
+    }
+    std::string directory = path.find('/') == std::string::npos ? "" : path.substr(0, path.rfind('/') + 1);
+    auto locate = [&](const std::string& map) {
+        std::string base = map.find('/') == std::string::npos ? map : map.substr(map.rfind('/') + 1);
+        for (const std::string& candidate : {map, directory + map, directory + base}) {
+            if (std::ifstream(candidate)) {
+                return candidate;
+            }
+        }
+        throw std::runtime_error("cannot find map " + map + " for scenario " + path);
+    };
+    std::map<std::string, std::vector<ScenarioQuery>> by_map;
+    for (const auto& query : scenario) {
+        by_map[query.map].push_back(query);
+    }
+    std::cout << "Scenario " << path << ": " << scenario.size() << " queries on " << by_map.size() << " maps"
+              << std::endl;
+
+    BenchmarkTotals octile;
+    BenchmarkTotals four_connected;
+    std::size_t matched = 0;
+    double worst_error = 0.0;
+    for (const auto& entry : by_map) {
+        auto data_matrix = load_movingai_map(locate(entry.first));
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+        for (const auto& query : entry.second) {
+            if (query.height != static_cast<int>(data_matrix.size()) ||
+                query.width != static_cast<int>(data_matrix[0].size())) {
+                throw std::runtime_error("scenario " + path + " gives a different size for map " + entry.first);
+            }
+            // Loading checked the cells against the size; walls are only
+            // known now.
+            for (auto cell : {query.start, query.goal}) {
+                if (data_matrix[cell.first][cell.second] == -1) {
+                    throw std::runtime_error("scenario " + path + " puts (" + std::to_string(cell.first) + "," +
+                                             std::to_string(cell.second) + ") on a wall of map " + entry.first);
+                }
+            }
+            queries.emplace_back(query.start, query.goal);
+        }
+        OctileGridGraph octile_grid(data_matrix);
+        SearchCore<OctileGridGraph> octile_search(octile_grid);
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& query : entry.second) {
+            SearchResult result = octile_search.solve(octile_grid.node(query.start.first, query.start.second),
+                                                      octile_grid.node(query.goal.first, query.goal.second));
+            octile.expanded += result.expanded;
+            if (result.found) {
+                octile.found++;
+                octile.cost += result.cost;
+                // Float path costs drift from the file's doubles by about
+                // one part in 10^7 per step.
+                double error = std::abs(result.cost - query.optimal_length);
+                worst_error = std::max(worst_error, error);
+                if (error <= 1e-3 + 2e-5 * query.optimal_length) {
+                    matched++;
+                }
+            }
+        }
+        octile.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        GridGraph grid(data_matrix);
+        BenchmarkTotals totals = run_queries(grid, queries);
+        four_connected.seconds += totals.seconds;
+        four_connected.expanded += totals.expanded;
+        four_connected.found += totals.found;
+        four_connected.cost += totals.cost;
+    }
+    print_totals("octile, as the scenario", octile, scenario.size());
+    std::cout << "  " << matched << " of " << scenario.size() << " costs match the scenario's optimal length"
+              << " (largest difference " << worst_error << ")" << std::endl;
+    print_totals("4-connected, cell costs", four_connected, scenario.size());
+    return matched == scenario.size() ? 0 : 1;
+}
+
+// Plain and rectangle-reduced search on maps from open to rough: empty
+// and open fields and rooms (cost 1 everywhere), noise terrain (smooth
+// cost bands) and uniform random costs, where rectangles are mostly
+// single cells.
+inline void run_rectangle_benchmark(int size, int query_count) {
+    std::cout << "Rectangle symmetry benchmark: " << size << "x" << size << ", " << query_count << " queries per map"
+              << std::endl;
+    const std::pair<const char*, std::vector<std::vector<int>>> maps[] = {
+        {"empty field", open_field_grid(size, size, 42, 0.0)},
+        {"open field", open_field_grid(size, size, 42)},
+        {"rooms", rooms_grid(size, size, 32, 42)},
+        {"noise terrain", noise_terrain_grid(size, size, 42)},
+        {"uniform random", random_grid(size, size, 0.2, 42)},
+    };
+    for (const auto& named : maps) {
+        GridGraph grid(named.second);
+        auto queries = random_queries(named.second, query_count, 7);
+        auto begin = std::chrono::steady_clock::now();
+        RectangleDecomposition decomposition(grid);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << named.first << ": " << decomposition.rectangle_count() << " rectangles, "
+                  << decomposition.perimeter_count() << " perimeter cells, preprocessing " << seconds * 1e3 << " ms"
+                  << std::endl;
+        print_totals("  plain", run_queries(grid, queries), queries.size());
+
+        RectangleSearch search(decomposition);
+        BenchmarkTotals totals =
+            run_queries_by(grid, queries, [&](int initial, int target) { return search.execute(initial, target); });
+        print_totals("  rectangles", totals, queries.size());
+    }
+}
+
+// Whether `path` is a chain of GridGraph edges from initial to target over
+// passable cells whose entered costs add up to `cost`.
+inline bool valid_grid_path(const GridGraph& grid, const std::vector<int>& path, int initial, int target,
+                            float cost) {
+    if (path.empty() || path.front() != initial || path.back() != target) {
+        return false;
+    }
+    float sum = 0.0f;
+    for (std::size_t i = 1; i < path.size(); i++) {
+        auto from = grid.coordinates(path[i - 1]);
+        auto to = grid.coordinates(path[i]);
+        if (std::abs(from.first - to.first) + std::abs(from.second - to.second) != 1 || !grid.passable(path[i])) {
+            return false;
+        }
+        sum += static_cast<float>(grid.cost(path[i]));
+    }
+    return sum == cost;
+}
+
+// RectangleSearch against SearchCore on the GridGraph over generated maps
+// of every kind and several seeds. All of them cost at least 1 per cell,
+// so both searches are optimal and must agree on found and cost; every
+// path is also checked cell by cell. Returns false on any mismatch.
+inline bool verify_rectangle_search(int seeds, int query_count) {
+    std::cout << "Rectangle symmetry check: " << seeds << " seeds, " << query_count << " queries per map" << std::endl;
+    std::size_t checked = 0;
+    std::size_t mismatches = 0;
+    for (unsigned seed = 1; seed <= static_cast<unsigned>(seeds); seed++) {
+        const std::pair<const char*, std::vector<std::vector<int>>> maps[] = {
+            {"empty field", open_field_grid(64, 72, seed, 0.0)},
+            {"open field", open_field_grid(96, 80, seed)},
+            {"rooms", rooms_grid(90, 90, 7, seed)},
+            {"noise terrain", noise_terrain_grid(100, 100, seed, 3)},
+            {"maze", maze_grid(61, 61, seed, 3)},
+        };
+        for (const auto& named : maps) {
+            GridGraph grid(named.second);
+            RectangleDecomposition decomposition(grid);
+            RectangleSearch reduced(decomposition);
+            SearchCore<GridGraph> plain(grid);
+            for (const auto& q : random_queries(named.second, query_count, seed)) {
+                int initial = grid.node(q.first.first, q.first.second);
+                int target = grid.node(q.second.first, q.second.second);
+                SearchResult expected = plain.execute(initial, target);
+                SearchResult result = reduced.execute(initial, target);
+                checked++;
+                bool same = result.found == expected.found &&
+                            (!result.found || (result.cost == expected.cost &&
+                                               valid_grid_path(grid, result.path, initial, target, result.cost)));
+                if (!same) {
+                    if (mismatches == 0) {
+                        std::cout << named.first << " seed " << seed << ": (" << q.first.first << ","
+                                  << q.first.second << ") -> (" << q.second.first << "," << q.second.second
+                                  << ") cost " << result.cost << ", expected " << expected.cost << std::endl;
+                    }
+                    mismatches++;
+                }
+            }
+        }
+    }
+    std::cout << checked << " queries, " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0;
+}
+
+// SearchCore on the GridGraph against SimdGridSearch, which relaxes the
+// four neighbors of each expansion together. Both expand the same cells
+// in the same order, so only the time per expansion should differ; after
+// timing, every query is rerun on both and found, cost, expanded and path
+// must match. Returns false on any mismatch.
+inline bool run_simd_benchmark(int size, int query_count) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto queries = random_queries(data_matrix, query_count, 7);
+    std::cout << "SIMD relaxation benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+#if defined(__AVX2__)
+              << "AVX2 gathers"
+#elif defined(__SSE2__)
+              << "SSE2"
+#else
+              << "scalar lanes"
+#endif
+              << std::endl;
+
+    GridGraph grid(data_matrix);
+    BenchmarkTotals scalar = run_queries(grid, queries);
+    print_totals("scalar", scalar, queries.size());
+
+    SimdGridSearch<> search(grid);
+    BenchmarkTotals totals =
+        run_queries_by(grid, queries, [&](int initial, int target) { return search.execute(initial, target); });
+    print_totals("vectorized", totals, queries.size());
+    std::cout << "  ns per expansion: scalar " << scalar.seconds * 1e9 / std::max<std::size_t>(1, scalar.expanded)
+              << ", vectorized " << totals.seconds * 1e9 / std::max<std::size_t>(1, totals.expanded) << std::endl;
+
+    SearchCore<GridGraph> core(grid);
+    std::size_t mismatches = 0;
+    for (const auto& q : queries) {
+        int initial = grid.node(q.first.first, q.first.second);
+        int target = grid.node(q.second.first, q.second.second);
+        SearchResult expected = core.execute(initial, target);
+        SearchResult result = search.execute(initial, target);
+        if (result.found != expected.found || result.cost != expected.cost || result.expanded != expected.expanded ||
+            result.path != expected.path) {
+            if (mismatches == 0) {
+                std::cout << "  mismatch: (" << q.first.first << "," << q.first.second << ") -> (" << q.second.first
+                          << "," << q.second.second << ") cost " << result.cost << " expanded " << result.expanded
+                          << ", expected cost " << expected.cost << " expanded " << expected.expanded << std::endl;
+            }
+            mismatches++;
+        }
+    }
+    std::cout << "  checked " << queries.size() << " queries, " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0;
+}
+
+// Shared single grid against per-node replicas with pinned workers.
+inline void run_batch_benchmark(int size, int query_count, int threads) {
+    auto data_matrix = random_grid(size, size, 0.2, 42);
+    auto coordinate_queries = random_queries(data_matrix, query_count, 7);
+    std::vector<std::pair<int, int>> queries;
+    queries.reserve(coordinate_queries.size());
+    for (const auto& q : coordinate_queries) {
+        queries.emplace_back(q.first.first * size + q.first.second, q.second.first * size + q.second.second);
+    }
+    std::cout << "Batch benchmark: " << size << "x" << size << ", " << query_count << " queries, "
+              << threads << " threads, " << NumaTopology::detect().node_count() << " memory node(s)" << std::endl;
+
+    for (bool numa_aware : {false, true}) {
+        BatchOptions options;
+        options.threads = threads;
+        options.numa_aware = numa_aware;
+        std::atomic<int> unbound(0);
+        options.unbound_threads = &unbound;
+        auto begin = std::chrono::steady_clock::now();
+        auto results = run_batch<GridGraph>([&]() { return GridGraph(data_matrix); }, queries, options);
+        BenchmarkTotals totals;
+        totals.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        for (const auto& result : results) {
+            add_result(totals, result);
+        }
+        print_totals(numa_aware ? "numa-aware" : "shared", totals, queries.size());
+        if (unbound > 0) {
+            std::cout << "  " << unbound << " thread(s) could not be bound to their node" << std::endl;
+        }
+    }
+}
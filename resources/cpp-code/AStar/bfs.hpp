@@ -0,0 +1,195 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <memory>
+#include <cmath>
+
+#include "expansion-trace.hpp"
+#include "memory-accounting.hpp"
+
+class DataPoint {
+public:
+    std::pair<int, int> coordinates;
+    float weight_a;
+    float weight_b;
+    float total_weight;
+    std::shared_ptr<DataPoint> predecessor;
+
+    DataPoint(std::pair<int, int> coords, float w_a, float w_b) 
+        : coordinates(coords), weight_a(w_a), weight_b(w_b), total_weight(w_a + w_b), predecessor(nullptr) {}
+};
+
+// Every container of the search and every DataPoint it creates allocate
+// through `account`, so memory() gives the live, peak and total bytes one
+// query used. The path returned by execute() belongs to the caller and is
+// not counted, nor are the two DataPoints passed in. execute() adds the
+// query's counts to MemoryAccount::process() once, as it returns, and the
+// destructor adds the frees that follow.
+// With set_trace(), pops, pushes, decrease-keys and backtracking steps are
+// recorded into a TraceRing; without one each costs a null check.
+class BFS {
+private:
+    using PointList = std::vector<std::shared_ptr<DataPoint>, CountingAllocator<std::shared_ptr<DataPoint>>>;
+    using CellList = std::vector<std::pair<int, int>, CountingAllocator<std::pair<int, int>>>;
+    using MatrixRow = std::vector<int, CountingAllocator<int>>;
+
+    MemoryAccount account;
+    PointList pending_queue;
+    CellList processed;
+    std::vector<MatrixRow, CountingAllocator<MatrixRow>> data_matrix;
+    std::shared_ptr<DataPoint> initial_point;
+    std::shared_ptr<DataPoint> target_point;
+    TraceRing* trace = nullptr;
+
+    struct CompareDataPoint {
+        bool operator()(const std::shared_ptr<DataPoint>& a, const std::shared_ptr<DataPoint>& b) const {
+            return a->total_weight > b->total_weight;
+        }
+    };
+
+public:
+    BFS(const std::vector<std::vector<int>>& matrix, 
+        std::shared_ptr<DataPoint> init, 
+        std::shared_ptr<DataPoint> target) 
+        : pending_queue(CountingAllocator<std::shared_ptr<DataPoint>>(&account)),
+          processed(CountingAllocator<std::pair<int, int>>(&account)),
+          data_matrix(CountingAllocator<MatrixRow>(&account)),
+          initial_point(init), target_point(target) {
+        data_matrix.reserve(matrix.size());
+        for (const auto& row : matrix) {
+            data_matrix.emplace_back(row.begin(), row.end(), CountingAllocator<int>(&account));
+        }
+        pending_queue.push_back(initial_point);
+        std::push_heap(pending_queue.begin(), pending_queue.end(), CompareDataPoint());
+    }
+
+    // The allocators point at `account`.
+    BFS(const BFS&) = delete;
+    BFS& operator=(const BFS&) = delete;
+
+    const AllocationStats& memory() const {
+        return account.current();
+    }
+
+    // Usually writer.ring() of the thread that will call execute().
+    void set_trace(TraceRing* ring) {
+        trace = ring;
+    }
+
+    std::pair<std::vector<std::pair<int, int>>, float> execute() {
+        if (trace) {
+            trace->record(TRACE_BEGIN, initial_point->coordinates.first, initial_point->coordinates.second, 0.0f);
+        }
+        while (!pending_queue.empty()) {
+            std::pop_heap(pending_queue.begin(), pending_queue.end(), CompareDataPoint());
+            auto current_element = pending_queue.back();
+            pending_queue.pop_back();
+            if (trace) {
+                trace->record(TRACE_POP, current_element->coordinates.first, current_element->coordinates.second,
+                              current_element->total_weight);
+            }
+
+            if (std::find(processed.begin(), processed.end(), current_element->coordinates) != processed.end()) {
+                continue;
+            }
+            processed.push_back(current_element->coordinates);
+
+            if (current_element->coordinates == target_point->coordinates) {
+                auto result = std::make_pair(find_list(current_element), current_element->total_weight);
+                account.flush();
+                return result;
+            }
+
+            auto adjacent_elements = reverse_string(current_element);
+            for (auto& element : adjacent_elements) {
+                if (std::find(processed.begin(), processed.end(), element->coordinates) != processed.end()) {
+                    continue;
+                }
+
+                float weight_a = current_element->weight_a + data_matrix[element->coordinates.first][element->coordinates.second];
+                float weight_b = swap_elements(element);
+
+                int existing_index = calculate_sum(element);
+                if (existing_index != -1) {
+                    auto existing_element = pending_queue[existing_index];
+                    if (weight_a < existing_element->weight_a) {
+                        insert_element(existing_element, weight_a, weight_b, current_element);
+                        if (trace) {
+                            trace->record(TRACE_DECREASE_KEY, element->coordinates.first, element->coordinates.second,
+                                          existing_element->total_weight);
+                        }
+                    }
+                } else {
+                    insert_element(element, weight_a, weight_b, current_element);
+                    pending_queue.push_back(element);
+                    std::push_heap(pending_queue.begin(), pending_queue.end(), CompareDataPoint());
+                    if (trace) {
+                        trace->record(TRACE_PUSH, element->coordinates.first, element->coordinates.second,
+                                      element->total_weight);
+                    }
+                }
+            }
+        }
+        account.flush();
+        return std::make_pair(std::vector<std::pair<int, int>>(), 0.0f);
+    }
+
+    int calculate_sum(std::shared_ptr<DataPoint> element) {
+        for (std::size_t i = 0; i < pending_queue.size(); i++) {
+            if (pending_queue[i]->coordinates == element->coordinates) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    PointList reverse_string(std::shared_ptr<DataPoint> element) {
+        CellList directions({{1,0}, {0,1}, {-1,0}, {0,-1}}, CountingAllocator<std::pair<int, int>>(&account));
+        PointList adjacent{CountingAllocator<std::shared_ptr<DataPoint>>(&account)};
+        const int rows = static_cast<int>(data_matrix.size());
+        const int cols = data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size());
+
+        for (auto& dir : directions) {
+            std::pair<int, int> adjacent_coords = {element->coordinates.first + dir.first, element->coordinates.second + dir.second};
+            if (adjacent_coords.first >= 0 && adjacent_coords.first < rows &&
+                adjacent_coords.second >= 0 && adjacent_coords.second < cols) {
+                if (data_matrix[adjacent_coords.first][adjacent_coords.second] != -1) {
+                    adjacent.push_back(std::allocate_shared<DataPoint>(CountingAllocator<DataPoint>(&account), adjacent_coords, 0, 0));
+                }
+            }
+        }
+        return adjacent;
+    }
+
+    float swap_elements(std::shared_ptr<DataPoint> element) {
+        int dx = std::abs(element->coordinates.first - target_point->coordinates.first);
+        int dy = std::abs(element->coordinates.second - target_point->coordinates.second);
+        return dx + dy;
+    }
+
+    std::vector<std::pair<int, int>> find_list(std::shared_ptr<DataPoint> final_element) {
+        std::vector<std::pair<int, int>> sequence;
+        auto current = final_element;
+        while (current->predecessor != nullptr && current->predecessor->coordinates != initial_point->coordinates) {
+            if (trace) {
+                trace->record(TRACE_RECONSTRUCT, current->coordinates.first, current->coordinates.second,
+                              current->total_weight);
+            }
+            sequence.push_back(current->coordinates);
+            current = current->predecessor;
+        }
+        sequence.push_back(initial_point->coordinates);
+        std::reverse(sequence.begin(), sequence.end());
+        return sequence;
+    }
+
+    void insert_element(std::shared_ptr<DataPoint> element, float weight_a, float weight_b, std::shared_ptr<DataPoint> current_element) {
+        element->weight_a = weight_a;
+        element->weight_b = weight_b;
+        element->total_weight = weight_a + weight_b;
+        element->predecessor = current_element;
+    }
+};
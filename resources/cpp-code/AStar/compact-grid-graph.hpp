@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+// GridGraph with the same node ids, edge order and heuristic, stored in
+// one byte per cell plus one bit per cell. Costs are uint8_t (walls hold 0
+// there) and passability is a bitmask with each row padded to whole 64-bit
+// words, so one load answers the wall test for 64 cells of a row and the
+// cost byte is only read for cells that can be entered. A 0-8 cost map
+// takes 1.125 bytes per cell instead of GridGraph's 4.
+class CompactGridGraph {
+private:
+    int rows;
+    int cols;
+    int words_per_row;
+    std::vector<std::uint8_t> costs;
+    std::vector<std::uint64_t> open_bits;
+
+    bool open(int r, int c) const {
+        return (open_bits[static_cast<std::size_t>(r) * words_per_row + (c >> 6)] >> (c & 63)) & 1;
+    }
+
+public:
+    explicit CompactGridGraph(const std::vector<std::vector<int>>& data_matrix)
+        : rows(static_cast<int>(data_matrix.size())),
+          cols(data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size())),
+          words_per_row((cols + 63) / 64) {
+        costs.assign(static_cast<std::size_t>(rows) * cols, 0);
+        open_bits.assign(static_cast<std::size_t>(rows) * words_per_row, 0);
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int value = data_matrix[r][c];
+                if (value == -1) {
+                    continue;
+                }
+                if (value < 0 || value > 255) {
+                    throw std::invalid_argument("CompactGridGraph: cell costs must be -1 or 0-255");
+                }
+                costs[static_cast<std::size_t>(r) * cols + c] = static_cast<std::uint8_t>(value);
+                open_bits[static_cast<std::size_t>(r) * words_per_row + (c >> 6)] |= std::uint64_t(1) << (c & 63);
+            }
+        }
+    }
+
+    int node_count() const {
+        return rows * cols;
+    }
+
+    int row_count() const {
+        return rows;
+    }
+
+    int column_count() const {
+        return cols;
+    }
+
+    int node(int r, int c) const {
+        return r * cols + c;
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        return {node / cols, node % cols};
+    }
+
+    int cost(int node) const {
+        return passable(node) ? costs[node] : -1;
+    }
+
+    bool passable(int node) const {
+        return open(node / cols, node % cols);
+    }
+
+    // Passability of cells first_col .. first_col + 63 of row r, where
+    // first_col is a multiple of 64; bit i is column first_col + i.
+    std::uint64_t passable_word(int r, int first_col) const {
+        return open_bits[static_cast<std::size_t>(r) * words_per_row + (first_col >> 6)];
+    }
+
+    std::size_t memory_bytes() const {
+        return costs.size() * sizeof(std::uint8_t) + open_bits.size() * sizeof(std::uint64_t);
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        int r = node / cols;
+        int c = node % cols;
+        if (r + 1 < rows && open(r + 1, c)) {
+            visit(node + cols, static_cast<float>(costs[node + cols]));
+        }
+        if (c + 1 < cols && open(r, c + 1)) {
+            visit(node + 1, static_cast<float>(costs[node + 1]));
+        }
+        if (r > 0 && open(r - 1, c)) {
+            visit(node - cols, static_cast<float>(costs[node - cols]));
+        }
+        if (c > 0 && open(r, c - 1)) {
+            visit(node - 1, static_cast<float>(costs[node - 1]));
+        }
+    }
+
+    float heuristic(int node, int target) const {
+        return static_cast<float>(std::abs(node / cols - target / cols) + std::abs(node % cols - target % cols));
+    }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+// Space-time reservations shared by cooperatively planned agents. Each
+// (cell, t) slot is hashed into one 64-bit key and maps to the agent that
+// holds it, which is also enough to detect two agents swapping cells.
+class ReservationTable {
+private:
+    std::unordered_map<std::uint64_t, int> slots;
+    std::unordered_map<int, int> parked_from;
+    std::unordered_map<int, int> last_reserved;
+
+    static std::uint64_t key(int cell, int t) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(t)) << 32) | static_cast<std::uint32_t>(cell);
+    }
+
+public:
+    static constexpr int NO_AGENT = -1;
+
+    int owner(int cell, int t) const {
+        auto parked = parked_from.find(cell);
+        if (parked != parked_from.end() && t >= parked->second) {
+            return slots.at(key(cell, parked->second));
+        }
+        auto it = slots.find(key(cell, t));
+        return it == slots.end() ? NO_AGENT : it->second;
+    }
+
+    bool is_reserved(int cell, int t) const {
+        return owner(cell, t) != NO_AGENT;
+    }
+
+    bool is_swap(int from, int to, int t) const {
+        int a = owner(to, t);
+        return a != NO_AGENT && a == owner(from, t + 1);
+    }
+
+    int last_reserved_time(int cell) const {
+        auto it = last_reserved.find(cell);
+        return it == last_reserved.end() ? -1 : it->second;
+    }
+
+    void reserve(int cell, int t, int agent) {
+        slots[key(cell, t)] = agent;
+        int& last = last_reserved.emplace(cell, t).first->second;
+        last = std::max(last, t);
+    }
+
+    // The agent stays on its goal forever once it arrives.
+    void park(int cell, int t, int agent) {
+        reserve(cell, t, agent);
+        parked_from[cell] = t;
+    }
+
+    void reserve_path(const std::vector<int>& cells, int agent) {
+        if (cells.empty()) {
+            return;
+        }
+        for (int t = 0; t < static_cast<int>(cells.size()); t++) {
+            reserve(cells[t], t, agent);
+        }
+        park(cells.back(), static_cast<int>(cells.size()) - 1, agent);
+    }
+
+    void clear() {
+        slots.clear();
+        parked_from.clear();
+        last_reserved.clear();
+    }
+};
+
+// A* over (cell, t) that treats slots held in a ReservationTable as blocked.
+// Moves cost the entered cell as in BFS::execute(); waiting in place costs
+// wait_weight so that idling is never free.
+class CooperativeBFS {
+private:
+    struct TimedPoint {
+        int cell;
+        int t;
+        float weight_a;
+        float total_weight;
+        int predecessor;
+    };
+
+    // Equal-cost plans are ordered by arrival time, so zero-cost cells do not
+    // make the search wander back and forth before heading to the goal.
+    struct QueueEntry {
+        float total_weight;
+        int arrival;
+        int index;
+    };
+
+    struct CompareTimedPoint {
+        bool operator()(const QueueEntry& a, const QueueEntry& b) const {
+            if (a.total_weight != b.total_weight) {
+                return a.total_weight > b.total_weight;
+            }
+            return a.arrival > b.arrival;
+        }
+    };
+
+    const std::vector<std::vector<int>>& data_matrix;
+    const ReservationTable& reservations;
+    int rows;
+    int cols;
+    int max_time;
+    float wait_weight;
+
+    std::vector<TimedPoint> nodes;
+    std::vector<QueueEntry> pending_queue;
+    std::unordered_map<std::uint64_t, int> best_node;
+
+    static std::uint64_t key(int cell, int t) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(t)) << 32) | static_cast<std::uint32_t>(cell);
+    }
+
+    int distance(int cell, int target) const {
+        return std::abs(cell / cols - target / cols) + std::abs(cell % cols - target % cols);
+    }
+
+    float swap_elements(int cell, int target) const {
+        return static_cast<float>(distance(cell, target));
+    }
+
+public:
+    CooperativeBFS(const std::vector<std::vector<int>>& matrix, const ReservationTable& table,
+                   int horizon, float wait = 1.0f)
+        : data_matrix(matrix), reservations(table),
+          rows(static_cast<int>(matrix.size())), cols(matrix.empty() ? 0 : static_cast<int>(matrix[0].size())),
+          max_time(horizon), wait_weight(wait) {}
+
+    // Returns one cell per time step, starting at t = 0, and the path cost.
+    std::pair<std::vector<std::pair<int, int>>, float> execute(std::pair<int, int> initial, std::pair<int, int> target) {
+        nodes.clear();
+        pending_queue.clear();
+        best_node.clear();
+
+        int start = initial.first * cols + initial.second;
+        int goal = target.first * cols + target.second;
+        if (reservations.is_reserved(start, 0)) {
+            return std::make_pair(std::vector<std::pair<int, int>>(), 0.0f);
+        }
+
+        nodes.push_back({start, 0, 0.0f, swap_elements(start, goal), -1});
+        best_node[key(start, 0)] = 0;
+        pending_queue.push_back({nodes[0].total_weight, distance(start, goal), 0});
+
+        const int dr[5] = {1, 0, -1, 0, 0};
+        const int dc[5] = {0, 1, 0, -1, 0};
+
+        while (!pending_queue.empty()) {
+            std::pop_heap(pending_queue.begin(), pending_queue.end(), CompareTimedPoint());
+            QueueEntry entry = pending_queue.back();
+            pending_queue.pop_back();
+
+            int index = entry.index;
+            TimedPoint current = nodes[index];
+            if (entry.total_weight > current.total_weight) {
+                continue;
+            }
+            if (current.cell == goal && current.t > reservations.last_reserved_time(goal)) {
+                return std::make_pair(find_list(index), current.weight_a);
+            }
+            if (current.t >= max_time) {
+                continue;
+            }
+
+            int r = current.cell / cols;
+            int c = current.cell % cols;
+            int t = current.t + 1;
+            for (int d = 0; d < 5; d++) {
+                int nr = r + dr[d];
+                int nc = c + dc[d];
+                if (nr < 0 || nr >= rows || nc < 0 || nc >= cols || data_matrix[nr][nc] == -1) {
+                    continue;
+                }
+                int next = nr * cols + nc;
+                if (reservations.is_reserved(next, t) || reservations.is_swap(current.cell, next, current.t)) {
+                    continue;
+                }
+
+                float weight_a = current.weight_a + (d == 4 ? wait_weight : static_cast<float>(data_matrix[nr][nc]));
+                auto found = best_node.find(key(next, t));
+                if (found != best_node.end() && nodes[found->second].weight_a <= weight_a) {
+                    continue;
+                }
+
+                float total = weight_a + swap_elements(next, goal);
+                int slot = static_cast<int>(nodes.size());
+                if (found != best_node.end()) {
+                    slot = found->second;
+                    nodes[slot] = {next, t, weight_a, total, index};
+                } else {
+                    nodes.push_back({next, t, weight_a, total, index});
+                    best_node.emplace(key(next, t), slot);
+                }
+                pending_queue.push_back({total, t + distance(next, goal), slot});
+                std::push_heap(pending_queue.begin(), pending_queue.end(), CompareTimedPoint());
+            }
+        }
+        return std::make_pair(std::vector<std::pair<int, int>>(), 0.0f);
+    }
+
+    std::vector<std::pair<int, int>> find_list(int index) const {
+        std::vector<std::pair<int, int>> sequence;
+        for (int i = index; i != -1; i = nodes[i].predecessor) {
+            sequence.emplace_back(nodes[i].cell / cols, nodes[i].cell % cols);
+        }
+        std::reverse(sequence.begin(), sequence.end());
+        return sequence;
+    }
+};
+
+// Plans agents in order; each plan is written into the table before the next
+// agent searches, so the returned paths are collision free in one pass.
+// An agent that cannot be routed within the horizon gets an empty path and
+// is parked on its start cell from t = 0, so later agents route around it.
+// Plans made before it are not revisited, so one that crosses its start
+// cell still conflicts with it.
+inline std::vector<std::pair<std::vector<std::pair<int, int>>, float>> plan_cooperative(
+        const std::vector<std::vector<int>>& data_matrix,
+        const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>& agents,
+        ReservationTable& reservations, int horizon, float wait_weight = 1.0f) {
+    std::vector<std::pair<std::vector<std::pair<int, int>>, float>> plans;
+    plans.reserve(agents.size());
+    int cols = data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size());
+
+    CooperativeBFS search(data_matrix, reservations, horizon, wait_weight);
+    for (int agent = 0; agent < static_cast<int>(agents.size()); agent++) {
+        auto plan = search.execute(agents[agent].first, agents[agent].second);
+        if (!plan.first.empty()) {
+            std::vector<int> cells;
+            cells.reserve(plan.first.size());
+            for (const auto& p : plan.first) {
+                cells.push_back(p.first * cols + p.second);
+            }
+            reservations.reserve_path(cells, agent);
+        } else {
+            int start = agents[agent].first.first * cols + agents[agent].first.second;
+            if (!reservations.is_reserved(start, 0)) {
+                reservations.park(start, 0, agent);
+            }
+        }
+        plans.push_back(std::move(plan));
+    }
+    return plans;
+}
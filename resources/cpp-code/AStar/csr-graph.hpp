@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+// Compressed sparse row graph for road and navmesh data. The out-edges of
+// node n are targets[offsets[n] .. offsets[n + 1]) with matching weights, so
+// expanding a node streams through two contiguous arrays.
+class CsrGraph {
+public:
+    enum class Heuristic { ZERO, MANHATTAN, EUCLIDEAN };
+
+private:
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<float> weights;
+    std::vector<std::pair<float, float>> positions;
+    Heuristic heuristic_kind;
+
+public:
+    CsrGraph() : offsets(1, 0), heuristic_kind(Heuristic::ZERO) {}
+
+    CsrGraph(std::vector<int> offsets_, std::vector<int> targets_, std::vector<float> weights_)
+        : offsets(std::move(offsets_)), targets(std::move(targets_)), weights(std::move(weights_)),
+          heuristic_kind(Heuristic::ZERO) {
+        if (offsets.empty() || offsets.back() != static_cast<int>(targets.size()) || targets.size() != weights.size()) {
+            throw std::invalid_argument("CsrGraph: offsets, targets and weights do not agree");
+        }
+    }
+
+    // Builds the arrays from an unsorted edge list (from, to, weight).
+    static CsrGraph from_edges(int node_count, const std::vector<std::pair<std::pair<int, int>, float>>& edges) {
+        std::vector<int> offsets(node_count + 1, 0);
+        for (const auto& e : edges) {
+            offsets[e.first.first + 1]++;
+        }
+        for (int n = 0; n < node_count; n++) {
+            offsets[n + 1] += offsets[n];
+        }
+        std::vector<int> targets(edges.size());
+        std::vector<float> weights(edges.size());
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (const auto& e : edges) {
+            int slot = cursor[e.first.first]++;
+            targets[slot] = e.first.second;
+            weights[slot] = e.second;
+        }
+        return CsrGraph(std::move(offsets), std::move(targets), std::move(weights));
+    }
+
+    // Node positions enable an A* heuristic; without them the search is Dijkstra.
+    void set_positions(std::vector<std::pair<float, float>> positions_, Heuristic kind) {
+        if (static_cast<int>(positions_.size()) != node_count()) {
+            throw std::invalid_argument("CsrGraph: one position per node is required");
+        }
+        positions = std::move(positions_);
+        heuristic_kind = kind;
+    }
+
+    int node_count() const {
+        return static_cast<int>(offsets.size()) - 1;
+    }
+
+    int edge_count() const {
+        return static_cast<int>(targets.size());
+    }
+
+    const std::vector<int>& edge_offsets() const {
+        return offsets;
+    }
+
+    const std::vector<int>& edge_targets() const {
+        return targets;
+    }
+
+    const std::vector<float>& edge_weights() const {
+        return weights;
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        const int end = offsets[node + 1];
+        for (int e = offsets[node]; e < end; e++) {
+            visit(targets[e], weights[e]);
+        }
+    }
+
+    float heuristic(int node, int target) const {
+        if (heuristic_kind == Heuristic::ZERO) {
+            return 0.0f;
+        }
+        float dx = positions[node].first - positions[target].first;
+        float dy = positions[node].second - positions[target].second;
+        if (heuristic_kind == Heuristic::MANHATTAN) {
+            return std::abs(dx) + std::abs(dy);
+        }
+        return std::sqrt(dx * dx + dy * dy);
+    }
+};
+
+// Turns a data_matrix grid into CSR with the same node numbering as
+// GridGraph (r * cols + c), the same neighbor order as reverse_string() and
+// the Manhattan heuristic of swap_elements(). Wall cells keep their node id
+// but get no edges in or out.
+inline CsrGraph grid_to_csr(const std::vector<std::vector<int>>& data_matrix) {
+    int rows = static_cast<int>(data_matrix.size());
+    int cols = data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size());
+    const int directions[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<float> weights;
+    std::vector<std::pair<float, float>> positions;
+    offsets.reserve(static_cast<size_t>(rows) * cols + 1);
+    targets.reserve(static_cast<size_t>(rows) * cols * 4);
+    weights.reserve(static_cast<size_t>(rows) * cols * 4);
+    positions.reserve(static_cast<size_t>(rows) * cols);
+
+    offsets.push_back(0);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            if (data_matrix[r][c] != -1) {
+                for (const auto& dir : directions) {
+                    int nr = r + dir[0];
+                    int nc = c + dir[1];
+                    if (nr >= 0 && nr < rows && nc >= 0 && nc < cols && data_matrix[nr][nc] != -1) {
+                        targets.push_back(nr * cols + nc);
+                        weights.push_back(static_cast<float>(data_matrix[nr][nc]));
+                    }
+                }
+            }
+            offsets.push_back(static_cast<int>(targets.size()));
+            positions.emplace_back(static_cast<float>(r), static_cast<float>(c));
+        }
+    }
+
+    CsrGraph graph(std::move(offsets), std::move(targets), std::move(weights));
+    graph.set_positions(std::move(positions), CsrGraph::Heuristic::MANHATTAN);
+    return graph;
+}
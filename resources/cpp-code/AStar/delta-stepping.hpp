@@ -0,0 +1,255 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Cost from one source to every node, and the predecessor of each node on
+// a cheapest path (-1 for the source and for unreachable nodes, whose
+// distance is infinity).
+struct DistanceField {
+    std::vector<float> distance;
+    std::vector<int> parent;
+};
+
+// Serial Dijkstra over the graph concept, the baseline delta_stepping()
+// is measured and checked against.
+template <class Graph>
+DistanceField dijkstra_field(const Graph& graph, int source) {
+    const int n = graph.node_count();
+    DistanceField field{std::vector<float>(n, std::numeric_limits<float>::infinity()), std::vector<int>(n, -1)};
+    std::vector<std::pair<float, int>> pending_queue;
+    field.distance[source] = 0.0f;
+    pending_queue.emplace_back(0.0f, source);
+    while (!pending_queue.empty()) {
+        std::pop_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+        auto top = pending_queue.back();
+        pending_queue.pop_back();
+        if (top.first > field.distance[top.second]) {
+            continue;
+        }
+        graph.for_each_edge(top.second, [&](int next, float weight) {
+            float d = top.first + weight;
+            if (d < field.distance[next]) {
+                field.distance[next] = d;
+                field.parent[next] = top.second;
+                pending_queue.emplace_back(d, next);
+                std::push_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+            }
+        });
+    }
+    return field;
+}
+
+// Fixed team of threads that run one task at a time together with the
+// calling thread; run() returns when every member has finished it.
+class WorkerTeam {
+private:
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable start;
+    std::condition_variable done;
+    std::function<void(int)> task;
+    std::uint64_t round = 0;
+    int running = 0;
+    bool stopping = false;
+
+public:
+    explicit WorkerTeam(int size) {
+        for (int id = 1; id < size; id++) {
+            workers.emplace_back([this, id]() {
+                std::uint64_t seen = 0;
+                while (true) {
+                    std::unique_lock<std::mutex> guard(lock);
+                    start.wait(guard, [&]() { return stopping || round != seen; });
+                    if (stopping) {
+                        return;
+                    }
+                    seen = round;
+                    guard.unlock();
+                    task(id);
+                    guard.lock();
+                    if (--running == 0) {
+                        done.notify_one();
+                    }
+                }
+            });
+        }
+    }
+
+    WorkerTeam(const WorkerTeam&) = delete;
+    WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+    ~WorkerTeam() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        start.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    void run(std::function<void(int)> task_) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            task = std::move(task_);
+            running = static_cast<int>(workers.size());
+            round++;
+        }
+        start.notify_all();
+        task(0);
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [&]() { return running == 0; });
+    }
+};
+
+// Parallel delta-stepping SSSP (Meyer and Sanders). Nodes sit in buckets of
+// width delta by tentative distance; the lowest bucket is settled in rounds
+// in which all threads relax the light edges (weight <= delta) of its nodes
+// at once, and heavy edges are relaxed once per bucket. Each distance and
+// its parent share one 64-bit atomic, lowered with compare-and-swap, so a
+// node's parent always matches its distance. Improvements go to per-thread
+// request buffers that are merged into the buckets between rounds.
+//
+// Edge weights must be non-negative. For the grid's 0-8 cell costs, delta
+// = 8 makes every edge light; smaller deltas mean more, cheaper rounds.
+template <class Graph>
+DistanceField delta_stepping(const Graph& graph, int source, float delta = 8.0f, int threads = 0) {
+    if (!(delta > 0.0f)) {
+        throw std::invalid_argument("delta_stepping: delta must be positive");
+    }
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const int n = graph.node_count();
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    auto pack = [](float distance, int parent) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        return (static_cast<std::uint64_t>(bits) << 32) | static_cast<std::uint32_t>(parent);
+    };
+    auto distance_of = [](std::uint64_t entry) {
+        std::uint32_t bits = static_cast<std::uint32_t>(entry >> 32);
+        float distance;
+        std::memcpy(&distance, &bits, sizeof(distance));
+        return distance;
+    };
+
+    std::vector<std::atomic<std::uint64_t>> state(n);
+    for (auto& entry : state) {
+        entry.store(pack(infinity, -1), std::memory_order_relaxed);
+    }
+    state[source].store(pack(0.0f, -1), std::memory_order_relaxed);
+
+    std::vector<std::vector<int>> buckets(1, std::vector<int>{source});
+    std::vector<std::vector<std::pair<std::size_t, int>>> requests(threads);
+    WorkerTeam team(threads);
+
+    // Lowers next's distance to `distance` via `from` if that is an
+    // improvement, and queues the bucket move in the worker's buffer.
+    auto relax = [&](int worker, int from, int next, float distance) {
+        std::uint64_t current = state[next].load(std::memory_order_relaxed);
+        while (distance < distance_of(current)) {
+            if (state[next].compare_exchange_weak(current, pack(distance, from), std::memory_order_relaxed)) {
+                requests[worker].emplace_back(static_cast<std::size_t>(distance / delta), next);
+                return;
+            }
+        }
+    };
+
+    auto merge_requests = [&]() {
+        for (auto& buffer : requests) {
+            for (const auto& request : buffer) {
+                if (request.first >= buckets.size()) {
+                    buckets.resize(request.first + 1);
+                }
+                buckets[request.first].push_back(request.second);
+            }
+            buffer.clear();
+        }
+    };
+
+    // Runs visit(worker, node) over `nodes` on the whole team, handing out
+    // chunks from a shared cursor.
+    auto for_all = [&](const std::vector<int>& nodes, auto&& visit) {
+        std::atomic<std::size_t> cursor(0);
+        const std::size_t chunk = 256;
+        team.run([&](int worker) {
+            while (true) {
+                std::size_t first = cursor.fetch_add(chunk, std::memory_order_relaxed);
+                if (first >= nodes.size()) {
+                    return;
+                }
+                std::size_t last = std::min(first + chunk, nodes.size());
+                for (std::size_t i = first; i < last; i++) {
+                    visit(worker, nodes[i]);
+                }
+            }
+        });
+    };
+
+    std::vector<int> frontier;
+    std::vector<int> settled;
+    for (std::size_t index = 0; index < buckets.size(); index++) {
+        settled.clear();
+        while (!buckets[index].empty()) {
+            frontier.swap(buckets[index]);
+            buckets[index].clear();
+            // Entries whose node has since moved to a lower bucket are stale.
+            frontier.erase(std::remove_if(frontier.begin(), frontier.end(), [&](int node) {
+                return static_cast<std::size_t>(distance_of(state[node].load(std::memory_order_relaxed)) / delta) != index;
+            }), frontier.end());
+            if (frontier.empty()) {
+                continue;
+            }
+            for_all(frontier, [&](int worker, int node) {
+                float base = distance_of(state[node].load(std::memory_order_relaxed));
+                graph.for_each_edge(node, [&](int next, float weight) {
+                    if (weight <= delta) {
+                        relax(worker, node, next, base + weight);
+                    }
+                });
+            });
+            settled.insert(settled.end(), frontier.begin(), frontier.end());
+            merge_requests();
+        }
+        std::sort(settled.begin(), settled.end());
+        settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+        if (settled.empty()) {
+            continue;
+        }
+        for_all(settled, [&](int worker, int node) {
+            float base = distance_of(state[node].load(std::memory_order_relaxed));
+            graph.for_each_edge(node, [&](int next, float weight) {
+                if (weight > delta) {
+                    relax(worker, node, next, base + weight);
+                }
+            });
+        });
+        merge_requests();
+    }
+
+    DistanceField field{std::vector<float>(n), std::vector<int>(n)};
+    for (int node = 0; node < n; node++) {
+        std::uint64_t entry = state[node].load(std::memory_order_relaxed);
+        field.distance[node] = distance_of(entry);
+        field.parent[node] = static_cast<int>(static_cast<std::uint32_t>(entry));
+    }
+    return field;
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum TraceEventKind : std::uint8_t {
+    TRACE_BEGIN,          // a search starts at (row, col)
+    TRACE_POP,
+    TRACE_PUSH,
+    TRACE_DECREASE_KEY,
+    TRACE_RECONSTRUCT,    // one backtracking step of find_list(), from (row, col)
+    TRACE_KIND_COUNT
+};
+
+inline const char* trace_kind_name(int kind) {
+    static const char* const names[TRACE_KIND_COUNT] = {"begin", "pop", "push", "decrease-key", "reconstruct"};
+    return kind >= 0 && kind < TRACE_KIND_COUNT ? names[kind] : "unknown";
+}
+
+// One event as it sits in a ring and in the trace file. weight is the
+// node's total weight (cost so far plus heuristic), 0 for TRACE_BEGIN.
+struct TraceEvent {
+    std::uint8_t kind;
+    std::uint8_t reserved[3];
+    std::int32_t row;
+    std::int32_t col;
+    float weight;
+};
+
+static_assert(sizeof(TraceEvent) == 16, "trace events are written to disk as is");
+
+// A trace file is the 8-byte trace_magic followed by blocks, each a
+// TraceBlockHeader and `count` TraceEvents of one thread in the order that
+// thread recorded them. Integers are in the writer's byte order.
+struct TraceBlockHeader {
+    std::uint32_t thread;    // ring index, in the order threads first recorded
+    std::uint32_t count;
+    std::uint64_t dropped;   // events this thread lost to a full ring since its previous block
+};
+
+constexpr char trace_magic[8] = {'A', 'S', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// One thread's events. The owning thread is the only producer and the
+// drain thread the only consumer; the positions are free-running counters
+// on their own cache lines, and the producer rereads the consumer's only
+// when its cached copy says the ring is full. A full ring drops the event
+// and counts it, so recording never waits on the drain.
+class alignas(64) TraceRing {
+public:
+    static constexpr std::uint64_t capacity = 1 << 16;
+
+private:
+    std::unique_ptr<TraceEvent[]> slots;
+    std::uint32_t ring_index;
+
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+    std::uint64_t cached_head = 0;
+    std::atomic<std::uint64_t> dropped{0};
+
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    std::uint64_t reported_dropped = 0;
+
+public:
+    // Slots are zeroed once; record() never writes `reserved`, so those
+    // bytes reach the file as zeros rather than uninitialised memory.
+    explicit TraceRing(std::uint32_t index) : slots(new TraceEvent[capacity]()), ring_index(index) {}
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    std::uint32_t index() const {
+        return ring_index;
+    }
+
+    void record(TraceEventKind kind, int row, int col, float weight) {
+        std::uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head == capacity) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head == capacity) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        TraceEvent& event = slots[t & (capacity - 1)];
+        event.kind = kind;
+        event.row = row;
+        event.col = col;
+        event.weight = weight;
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    // Consumer side: appends every published event to `out` and returns
+    // how many were dropped since the previous call.
+    std::uint64_t drain(std::vector<TraceEvent>& out) {
+        std::uint64_t h = head.load(std::memory_order_relaxed);
+        std::uint64_t t = tail.load(std::memory_order_acquire);
+        for (; h != t; h++) {
+            out.push_back(slots[h & (capacity - 1)]);
+        }
+        head.store(h, std::memory_order_release);
+        std::uint64_t total = dropped.load(std::memory_order_relaxed);
+        std::uint64_t lost = total - reported_dropped;
+        reported_dropped = total;
+        return lost;
+    }
+};
+
+// Writes the events of every thread's TraceRing to a file from a drain
+// thread of its own. A thread gets its ring from ring() on first use, which
+// takes a mutex once; from then on recording touches only that ring. A
+// thread that alternates between writers gets a new ring on each switch.
+// close() (or the destructor) drains what is left and stops the thread;
+// no ring may be recorded into after that.
+class TraceWriter {
+private:
+    std::FILE* file;
+    std::uint64_t writer_id;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    std::mutex ring_mutex;
+    std::atomic<bool> stopping{false};
+    bool write_failed = false;
+    std::uint64_t written = 0;
+    std::uint64_t lost = 0;
+    std::thread drainer;
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    bool drain_once(std::vector<TraceEvent>& buffer) {
+        std::vector<TraceRing*> current;
+        {
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            for (const auto& ring : rings) {
+                current.push_back(ring.get());
+            }
+        }
+        bool any = false;
+        for (TraceRing* ring : current) {
+            buffer.clear();
+            std::uint64_t dropped = ring->drain(buffer);
+            if (buffer.empty() && dropped == 0) {
+                continue;
+            }
+            TraceBlockHeader header{ring->index(), static_cast<std::uint32_t>(buffer.size()), dropped};
+            if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+                std::fwrite(buffer.data(), sizeof(TraceEvent), buffer.size(), file) != buffer.size()) {
+                write_failed = true;
+            }
+            written += buffer.size();
+            lost += dropped;
+            any = true;
+        }
+        return any;
+    }
+
+    void drain_loop() {
+        std::vector<TraceEvent> buffer;
+        buffer.reserve(TraceRing::capacity);
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (!drain_once(buffer)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        drain_once(buffer);
+    }
+
+    void stop() {
+        if (!drainer.joinable()) {
+            return;
+        }
+        stopping.store(true, std::memory_order_release);
+        drainer.join();
+        if (std::fclose(file) != 0) {
+            write_failed = true;
+        }
+        file = nullptr;
+    }
+
+public:
+    explicit TraceWriter(const std::string& path) : writer_id(next_id()) {
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error("cannot open trace file " + path);
+        }
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        if (std::fwrite(trace_magic, sizeof(trace_magic), 1, file) != 1) {
+            std::fclose(file);
+            throw std::runtime_error("cannot write trace file " + path);
+        }
+        drainer = std::thread([this]() { drain_loop(); });
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    ~TraceWriter() {
+        stop();
+    }
+
+    // The calling thread's ring, created on its first call.
+    TraceRing& ring() {
+        thread_local std::uint64_t owner = 0;
+        thread_local TraceRing* local = nullptr;
+        if (owner != writer_id) {
+            std::lock_guard<std::mutex> lock(ring_mutex);
+            rings.push_back(std::make_unique<TraceRing>(static_cast<std::uint32_t>(rings.size())));
+            local = rings.back().get();
+            owner = writer_id;
+        }
+        return *local;
+    }
+
+    // Stops the drain thread after a last pass. Throws std::runtime_error
+    // if any write failed.
+    void close() {
+        stop();
+        if (write_failed) {
+            throw std::runtime_error("trace file write failed");
+        }
+    }
+
+    // Only meaningful after close().
+    std::uint64_t events_written() const {
+        return written;
+    }
+
+    std::uint64_t events_dropped() const {
+        return lost;
+    }
+};
+
+// Reads a trace file, calling visit(thread, event) for every event in file
+// order, and returns the total of the blocks' dropped counts. Throws
+// std::runtime_error on a missing file, a bad magic or a truncated block.
+template <class Visit>
+std::uint64_t read_trace(const std::string& path, Visit&& visit) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+    if (!file) {
+        throw std::runtime_error("cannot open trace file " + path);
+    }
+    char magic[sizeof(trace_magic)];
+    if (std::fread(magic, sizeof(magic), 1, file.get()) != 1 || std::memcmp(magic, trace_magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("not a trace file: " + path);
+    }
+    std::uint64_t dropped = 0;
+    std::vector<TraceEvent> events;
+    TraceBlockHeader header;
+    while (std::fread(&header, sizeof(header), 1, file.get()) == 1) {
+        events.resize(header.count);
+        if (std::fread(events.data(), sizeof(TraceEvent), events.size(), file.get()) != events.size()) {
+            throw std::runtime_error("truncated trace file " + path);
+        }
+        dropped += header.dropped;
+        for (const TraceEvent& event : events) {
+            visit(header.thread, event);
+        }
+    }
+    return dropped;
+}
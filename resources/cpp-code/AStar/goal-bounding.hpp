@@ -0,0 +1,188 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "grid-graph.hpp"
+#include "search-core.hpp"
+
+// Goal-bounding tables for a GridGraph. For every cell and each of its four
+// moves (down, right, up, left, the order of for_each_edge), the box of all
+// cells whose cheapest path from that cell starts with that move. A move
+// whose box does not hold the goal cannot start an optimal path to it.
+//
+// Building runs one Dijkstra per cell, so it is quadratic in the map size
+// and meant for maps that are preprocessed once and queried many times.
+// Boxes are stored as 16-bit coordinates, 32 bytes per cell.
+class GoalBounds {
+public:
+    struct Box {
+        std::uint16_t min_row;
+        std::uint16_t max_row;
+        std::uint16_t min_col;
+        std::uint16_t max_col;
+
+        bool contains(int r, int c) const {
+            return r >= min_row && r <= max_row && c >= min_col && c <= max_col;
+        }
+    };
+
+private:
+    int cols;
+    std::vector<Box> boxes;
+
+    static int direction(int node, int next, int cols) {
+        if (next == node + cols) {
+            return 0;
+        }
+        if (next == node + 1) {
+            return 1;
+        }
+        if (next == node - cols) {
+            return 2;
+        }
+        return 3;
+    }
+
+    // Dijkstra from source; every settled cell grows the box of the first
+    // move on the path the search found to it.
+    void build_from(const GridGraph& grid, int source, std::vector<float>& distance, std::vector<int>& first_move,
+                    std::vector<std::pair<float, int>>& pending_queue) {
+        std::fill(distance.begin(), distance.end(), std::numeric_limits<float>::infinity());
+        pending_queue.clear();
+        distance[source] = 0.0f;
+        first_move[source] = -1;
+        pending_queue.emplace_back(0.0f, source);
+        while (!pending_queue.empty()) {
+            std::pop_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+            auto top = pending_queue.back();
+            pending_queue.pop_back();
+            int current = top.second;
+            if (top.first > distance[current]) {
+                continue;
+            }
+            if (current != source) {
+                auto p = grid.coordinates(current);
+                Box& box = boxes[static_cast<std::size_t>(source) * 4 + first_move[current]];
+                box.min_row = std::min<std::uint16_t>(box.min_row, static_cast<std::uint16_t>(p.first));
+                box.max_row = std::max<std::uint16_t>(box.max_row, static_cast<std::uint16_t>(p.first));
+                box.min_col = std::min<std::uint16_t>(box.min_col, static_cast<std::uint16_t>(p.second));
+                box.max_col = std::max<std::uint16_t>(box.max_col, static_cast<std::uint16_t>(p.second));
+            }
+            grid.for_each_edge(current, [&](int next, float weight) {
+                float d = top.first + weight;
+                if (d < distance[next]) {
+                    distance[next] = d;
+                    first_move[next] = current == source ? direction(source, next, cols) : first_move[current];
+                    pending_queue.emplace_back(d, next);
+                    std::push_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+                }
+            });
+        }
+    }
+
+public:
+    // Builds the tables on `threads` threads (all CPUs when 0), each taking
+    // the next unprocessed source cell.
+    GoalBounds(const GridGraph& grid, int threads = 0) : cols(grid.column_count()) {
+        if (grid.row_count() > 65535 || grid.column_count() > 65535) {
+            throw std::invalid_argument("GoalBounds supports maps of at most 65535 rows and columns");
+        }
+        const int n = grid.node_count();
+        boxes.assign(static_cast<std::size_t>(n) * 4, Box{65535, 0, 65535, 0});
+        if (threads <= 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::atomic<int> next_source(0);
+        auto work = [&]() {
+            std::vector<float> distance(n);
+            std::vector<int> first_move(n);
+            std::vector<std::pair<float, int>> pending_queue;
+            for (int source = next_source++; source < n; source = next_source++) {
+                if (grid.passable(source)) {
+                    build_from(grid, source, distance, first_move, pending_queue);
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) {
+            pool.emplace_back(work);
+        }
+        work();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    const Box& box(int node, int move) const {
+        return boxes[static_cast<std::size_t>(node) * 4 + move];
+    }
+
+    bool allows(int node, int next, int target_row, int target_col) const {
+        return boxes[static_cast<std::size_t>(node) * 4 + direction(node, next, cols)].contains(target_row, target_col);
+    }
+};
+
+// GridGraph whose edges are filtered by GoalBounds for one target at a
+// time; set_target() must be called before each search. The per-edge cost
+// is four comparisons against a box that sits next to its siblings.
+class GoalBoundedGraph {
+private:
+    const GridGraph& grid;
+    const GoalBounds& bounds;
+    int target_row;
+    int target_col;
+
+public:
+    GoalBoundedGraph(const GridGraph& grid_, const GoalBounds& bounds_)
+        : grid(grid_), bounds(bounds_), target_row(0), target_col(0) {}
+
+    void set_target(int target) {
+        auto p = grid.coordinates(target);
+        target_row = p.first;
+        target_col = p.second;
+    }
+
+    int node_count() const {
+        return grid.node_count();
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        grid.for_each_edge(node, [&](int next, float weight) {
+            if (bounds.allows(node, next, target_row, target_col)) {
+                visit(next, weight);
+            }
+        });
+    }
+
+    float heuristic(int node, int target) const {
+        return grid.heuristic(node, target);
+    }
+};
+
+// SearchCore over a GoalBoundedGraph that points the filter at each
+// query's target.
+class GoalBoundedSearch {
+private:
+    GoalBoundedGraph graph;
+    SearchCore<GoalBoundedGraph> core;
+
+public:
+    GoalBoundedSearch(const GridGraph& grid, const GoalBounds& bounds) : graph(grid, bounds), core(graph) {}
+
+    GoalBoundedSearch(const GoalBoundedSearch&) = delete;
+    GoalBoundedSearch& operator=(const GoalBoundedSearch&) = delete;
+
+    SearchResult execute(int initial, int target) {
+        graph.set_target(target);
+        return core.execute(initial, target);
+    }
+};
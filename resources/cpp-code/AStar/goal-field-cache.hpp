@@ -0,0 +1,232 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "search-core.hpp"
+
+// Cost-to-go from every cell to one goal and the move that starts a
+// cheapest path from it (0-3 in for_each_edge order: down, right, up,
+// left; -1 at the goal and where the goal cannot be reached).
+struct GoalField {
+    int goal = -1;
+    std::uint64_t version = 0;
+    std::vector<float> cost_to_go;
+    std::vector<std::int8_t> next_move;
+    std::size_t settled = 0;   // cells the build settled
+
+    std::size_t memory_bytes() const {
+        return cost_to_go.size() * sizeof(float) + next_move.size() * sizeof(std::int8_t);
+    }
+};
+
+// Builds the GoalField of `goal` with one Dijkstra run backwards from it;
+// a wall goal gets a field with every cost infinite.
+// Entering a cell costs that cell, so stepping from u onto v costs
+// grid.cost(v). Works for GridGraph and any grid with the same interface
+// (cost(), column_count(), for_each_edge() over symmetric neighbors), such
+// as GridSnapshot.
+template <class Grid>
+GoalField build_goal_field(const Grid& grid, int goal, std::uint64_t version) {
+    const int n = grid.node_count();
+    const int cols = grid.column_count();
+    GoalField field;
+    field.goal = goal;
+    field.version = version;
+    field.cost_to_go.assign(n, std::numeric_limits<float>::infinity());
+    field.next_move.assign(n, -1);
+    if (!grid.passable(goal)) {
+        return field;   // nothing can reach a wall
+    }
+    std::vector<std::pair<float, int>> pending_queue;
+    field.cost_to_go[goal] = 0.0f;
+    pending_queue.emplace_back(0.0f, goal);
+    while (!pending_queue.empty()) {
+        std::pop_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+        auto top = pending_queue.back();
+        pending_queue.pop_back();
+        int current = top.second;
+        if (top.first > field.cost_to_go[current]) {
+            continue;
+        }
+        field.settled++;
+        const float step = static_cast<float>(grid.cost(current));
+        grid.for_each_edge(current, [&](int previous, float) {
+            float d = top.first + step;
+            if (d < field.cost_to_go[previous]) {
+                field.cost_to_go[previous] = d;
+                // The move from previous back onto current.
+                int delta = current - previous;
+                field.next_move[previous] = delta == cols ? 0 : delta == 1 ? 1 : delta == -cols ? 2 : 3;
+                pending_queue.emplace_back(d, previous);
+                std::push_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+            }
+        });
+    }
+    return field;
+}
+
+enum class FieldEviction { LRU, LFU };
+
+// GoalFields of hot goals, kept within a byte budget. A query to a cached
+// goal walks next_move from the start in O(path length) and returns an
+// optimal path without searching. Each entry records the grid version it
+// was built for; a lookup with a newer version rebuilds it, and
+// invalidate_before() drops stale ones eagerly. A lookup with an older
+// version than the cached one (a reader still on an old grid) is served
+// from a scratch field that is built but never cached, so it cannot evict
+// or replace the current one. LFU evicts the entry with the fewest hits
+// (the least recent among equals), LRU the least recent. At least the
+// field being served is always kept, even when it alone is over budget.
+// Not thread-safe: give each worker its own cache.
+class GoalFieldCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t rebuilds = 0;   // misses caused by a newer grid version
+        std::size_t stale = 0;      // lookups older than the cached version, built uncached
+        std::size_t evictions = 0;
+    };
+
+private:
+    struct Entry {
+        std::unique_ptr<GoalField> field;
+        std::uint64_t last_used = 0;
+        std::uint64_t uses = 0;
+    };
+
+    std::size_t budget;
+    FieldEviction policy;
+    std::unordered_map<int, Entry> entries;
+    std::size_t used_bytes = 0;
+    std::uint64_t clock = 0;
+    Stats counters;
+    GoalField scratch;
+
+    void evict_until(std::size_t needed, int keep) {
+        while (used_bytes + needed > budget && entries.size() > (entries.count(keep) ? 1u : 0u)) {
+            auto victim = entries.end();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->first == keep) {
+                    continue;
+                }
+                if (victim == entries.end()) {
+                    victim = it;
+                    continue;
+                }
+                const Entry& a = it->second;
+                const Entry& b = victim->second;
+                bool older = a.last_used < b.last_used;
+                if (policy == FieldEviction::LFU ? (a.uses < b.uses || (a.uses == b.uses && older)) : older) {
+                    victim = it;
+                }
+            }
+            if (victim == entries.end()) {
+                return;
+            }
+            used_bytes -= victim->second.field->memory_bytes();
+            entries.erase(victim);
+            counters.evictions++;
+        }
+    }
+
+public:
+    explicit GoalFieldCache(std::size_t budget_bytes, FieldEviction policy_ = FieldEviction::LRU)
+        : budget(budget_bytes), policy(policy_) {}
+
+    // The field of `goal` for grid `version`, built on a miss. A field
+    // served for an older version than the cached one lives in scratch
+    // space and stays valid only until the next call.
+    template <class Grid>
+    const GoalField& field(const Grid& grid, std::uint64_t version, int goal) {
+        clock++;
+        auto found = entries.find(goal);
+        if (found != entries.end() && found->second.field->version == version) {
+            counters.hits++;
+            found->second.last_used = clock;
+            found->second.uses++;
+            return *found->second.field;
+        }
+        counters.misses++;
+        if (found != entries.end() && found->second.field->version > version) {
+            counters.stale++;
+            scratch = build_goal_field(grid, goal, version);
+            return scratch;
+        }
+        if (found != entries.end()) {
+            counters.rebuilds++;
+            used_bytes -= found->second.field->memory_bytes();
+            entries.erase(found);
+        }
+        auto built = std::make_unique<GoalField>(build_goal_field(grid, goal, version));
+        std::size_t bytes = built->memory_bytes();
+        evict_until(bytes, goal);
+        Entry& entry = entries[goal];
+        entry.field = std::move(built);
+        entry.last_used = clock;
+        entry.uses = 1;
+        used_bytes += bytes;
+        return *entry.field;
+    }
+
+    // Cheapest path from initial to goal by walking the goal's field;
+    // expanded is 0 on a hit and the cells settled building it on a miss.
+    template <class Grid>
+    SearchResult route(const Grid& grid, std::uint64_t version, int initial, int goal) {
+        std::size_t misses = counters.misses;
+        const GoalField& goal_field = field(grid, version, goal);
+        SearchResult result;
+        result.expanded = counters.misses != misses ? goal_field.settled : 0;
+        if (goal_field.cost_to_go[initial] == std::numeric_limits<float>::infinity()) {
+            return result;
+        }
+        const int cols = grid.column_count();
+        const int step[4] = {cols, 1, -cols, -1};
+        for (int node = initial; ; node += step[goal_field.next_move[node]]) {
+            result.path.push_back(node);
+            if (node == goal) {
+                break;
+            }
+        }
+        result.found = true;
+        result.cost = goal_field.cost_to_go[initial];
+        result.last_node = goal;
+        return result;
+    }
+
+    // Drops every field built for a grid version older than `version`.
+    void invalidate_before(std::uint64_t version) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.field->version < version) {
+                used_bytes -= it->second.field->memory_bytes();
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void clear() {
+        entries.clear();
+        used_bytes = 0;
+    }
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    std::size_t memory_bytes() const {
+        return used_bytes;
+    }
+
+    const Stats& stats() const {
+        return counters;
+    }
+};
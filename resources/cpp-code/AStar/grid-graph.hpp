@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <cstdlib>
+#include <utility>
+
+// Row-major view of a data_matrix grid that satisfies the search graph
+// concept used by SearchCore:
+//
+//     int node_count() const;
+//     template <class Visit> void for_each_edge(int node, Visit&& visit) const;   // visit(target, weight)
+//     float heuristic(int node, int target) const;
+//
+// Nodes are r * cols + c. Moving onto a cell costs that cell's value and
+// cells holding -1 are walls, exactly as in BFS::reverse_string().
+class GridGraph {
+private:
+    int rows;
+    int cols;
+    std::vector<int> costs;
+
+public:
+    explicit GridGraph(const std::vector<std::vector<int>>& data_matrix)
+        : rows(static_cast<int>(data_matrix.size())),
+          cols(data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size())) {
+        costs.reserve(static_cast<size_t>(rows) * cols);
+        for (const auto& row : data_matrix) {
+            costs.insert(costs.end(), row.begin(), row.end());
+        }
+    }
+
+    int node_count() const {
+        return rows * cols;
+    }
+
+    int row_count() const {
+        return rows;
+    }
+
+    int column_count() const {
+        return cols;
+    }
+
+    int node(int r, int c) const {
+        return r * cols + c;
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        return {node / cols, node % cols};
+    }
+
+    int cost(int node) const {
+        return costs[node];
+    }
+
+    bool passable(int node) const {
+        return costs[node] != -1;
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        int r = node / cols;
+        int c = node % cols;
+        if (r + 1 < rows && costs[node + cols] != -1) {
+            visit(node + cols, static_cast<float>(costs[node + cols]));
+        }
+        if (c + 1 < cols && costs[node + 1] != -1) {
+            visit(node + 1, static_cast<float>(costs[node + 1]));
+        }
+        if (r > 0 && costs[node - cols] != -1) {
+            visit(node - cols, static_cast<float>(costs[node - cols]));
+        }
+        if (c > 0 && costs[node - 1] != -1) {
+            visit(node - 1, static_cast<float>(costs[node - 1]));
+        }
+    }
+
+    float heuristic(int node, int target) const {
+        return static_cast<float>(std::abs(node / cols - target / cols) + std::abs(node % cols - target % cols));
+    }
+};
+
+// Non-owning GridGraph over an existing row-major (or strided) cell buffer,
+// e.g. a NumPy array, so the search reads the caller's memory in place.
+// Strides are in elements.
+template <class Cell>
+class GridView {
+private:
+    const Cell* cells;
+    int rows;
+    int cols;
+    long row_stride;
+    long col_stride;
+
+    Cell at(int node) const {
+        return cells[(node / cols) * row_stride + (node % cols) * col_stride];
+    }
+
+public:
+    GridView(const Cell* cells_, int rows_, int cols_, long row_stride_, long col_stride_ = 1)
+        : cells(cells_), rows(rows_), cols(cols_), row_stride(row_stride_), col_stride(col_stride_) {}
+
+    int node_count() const {
+        return rows * cols;
+    }
+
+    int row_count() const {
+        return rows;
+    }
+
+    int column_count() const {
+        return cols;
+    }
+
+    int node(int r, int c) const {
+        return r * cols + c;
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        return {node / cols, node % cols};
+    }
+
+    int cost(int node) const {
+        return static_cast<int>(at(node));
+    }
+
+    bool passable(int node) const {
+        return at(node) != -1;
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        int r = node / cols;
+        int c = node % cols;
+        const Cell* cell = cells + r * row_stride + c * col_stride;
+        if (r + 1 < rows && cell[row_stride] != -1) {
+            visit(node + cols, static_cast<float>(cell[row_stride]));
+        }
+        if (c + 1 < cols && cell[col_stride] != -1) {
+            visit(node + 1, static_cast<float>(cell[col_stride]));
+        }
+        if (r > 0 && cell[-row_stride] != -1) {
+            visit(node - cols, static_cast<float>(cell[-row_stride]));
+        }
+        if (c > 0 && cell[-col_stride] != -1) {
+            visit(node - 1, static_cast<float>(cell[-col_stride]));
+        }
+    }
+
+    float heuristic(int node, int target) const {
+        return static_cast<float>(std::abs(node / cols - target / cols) + std::abs(node % cols - target % cols));
+    }
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "grid-graph.hpp"
+#include "search-core.hpp"
+
+// Coarse-to-fine pyramid over a data_matrix. Level 0 is the map itself;
+// each cell of level k + 1 covers a factor x factor block of level k. A
+// coarse cell costs the mean of the passable cells of its block and is a
+// wall only when every cell of the block is one, so any fine path projects
+// onto a coarse path: when the top level has no path, the map has none
+// either. (The block minimum would be the strictly optimistic cost, but on
+// weighted maps it is nearly always 0 and the coarse path stops meaning
+// anything.)
+class GridPyramid {
+private:
+    std::vector<GridGraph> levels;
+    int factor;
+
+public:
+    GridPyramid(const std::vector<std::vector<int>>& data_matrix, int level_count, int factor_ = 2)
+        : factor(factor_) {
+        if (level_count < 1 || factor < 2) {
+            throw std::invalid_argument("GridPyramid needs at least one level and a factor of at least 2");
+        }
+        levels.emplace_back(data_matrix);
+        std::vector<std::vector<int>> finer = data_matrix;
+        for (int k = 1; k < level_count; k++) {
+            int rows = static_cast<int>(finer.size());
+            int cols = finer.empty() ? 0 : static_cast<int>(finer[0].size());
+            int coarse_rows = (rows + factor - 1) / factor;
+            int coarse_cols = (cols + factor - 1) / factor;
+            std::vector<std::vector<long>> sum(coarse_rows, std::vector<long>(coarse_cols, 0));
+            std::vector<std::vector<int>> open(coarse_rows, std::vector<int>(coarse_cols, 0));
+            for (int r = 0; r < rows; r++) {
+                for (int c = 0; c < cols; c++) {
+                    if (finer[r][c] != -1) {
+                        sum[r / factor][c / factor] += finer[r][c];
+                        open[r / factor][c / factor]++;
+                    }
+                }
+            }
+            std::vector<std::vector<int>> coarser(coarse_rows, std::vector<int>(coarse_cols, -1));
+            for (int r = 0; r < coarse_rows; r++) {
+                for (int c = 0; c < coarse_cols; c++) {
+                    if (open[r][c] > 0) {
+                        coarser[r][c] = static_cast<int>(sum[r][c] / open[r][c]);
+                    }
+                }
+            }
+            levels.emplace_back(coarser);
+            finer = std::move(coarser);
+        }
+    }
+
+    int level_count() const {
+        return static_cast<int>(levels.size());
+    }
+
+    int scale() const {
+        return factor;
+    }
+
+    const GridGraph& level(int k) const {
+        return levels[k];
+    }
+};
+
+// The cells of one pyramid level that fall inside a set of blocks of the
+// level above, renumbered densely so that a SearchCore over it only sizes
+// its arrays to the corridor. Local node = slot * factor^2 + offset in the
+// block; edges, their order and the heuristic are those of the level.
+class CorridorGraph {
+private:
+    const GridGraph& grid;
+    int factor;
+    std::vector<int> blocks;
+    std::unordered_map<int, int> slot_of_block;
+    int block_cols;
+
+public:
+    CorridorGraph(const GridGraph& grid_, int factor_, const std::vector<std::pair<int, int>>& block_cells)
+        : grid(grid_), factor(factor_), block_cols((grid_.column_count() + factor_ - 1) / factor_) {
+        blocks.reserve(block_cells.size());
+        for (const auto& b : block_cells) {
+            int block = b.first * block_cols + b.second;
+            if (slot_of_block.emplace(block, static_cast<int>(blocks.size())).second) {
+                blocks.push_back(block);
+            }
+        }
+    }
+
+    int node_count() const {
+        return static_cast<int>(blocks.size()) * factor * factor;
+    }
+
+    // -1 when the cell lies outside the corridor.
+    int local(int r, int c) const {
+        auto slot = slot_of_block.find((r / factor) * block_cols + c / factor);
+        if (slot == slot_of_block.end()) {
+            return -1;
+        }
+        return slot->second * factor * factor + (r % factor) * factor + c % factor;
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        int block = blocks[node / (factor * factor)];
+        int offset = node % (factor * factor);
+        return {(block / block_cols) * factor + offset / factor, (block % block_cols) * factor + offset % factor};
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        auto p = coordinates(node);
+        if (p.first >= grid.row_count() || p.second >= grid.column_count()) {
+            return;
+        }
+        grid.for_each_edge(grid.node(p.first, p.second), [&](int next, float weight) {
+            auto q = grid.coordinates(next);
+            int target = local(q.first, q.second);
+            if (target != -1) {
+                visit(target, weight);
+            }
+        });
+    }
+
+    float heuristic(int node, int target) const {
+        auto a = coordinates(node);
+        auto b = coordinates(target);
+        return static_cast<float>(std::abs(a.first - b.first) + std::abs(a.second - b.second));
+    }
+};
+
+struct PyramidResult : SearchResult {
+    std::size_t peak_nodes = 0;
+    int widenings = 0;
+};
+
+// Plans on the top level, then at each finer level searches only the
+// blocks under the coarse path dilated by `radius` cells. A level that
+// fails inside its corridor doubles the radius up to `max_widenings` times
+// and finally searches the whole level. The path is level-0 node ids; the
+// corridor can cost optimality, expanded and peak_nodes (the largest
+// per-level node count) are what it saves.
+inline PyramidResult pyramid_search(const GridPyramid& pyramid, std::pair<int, int> initial,
+                                    std::pair<int, int> target, int radius = 1, int max_widenings = 3) {
+    PyramidResult result;
+    const int top = pyramid.level_count() - 1;
+    int scale = 1;
+    for (int k = 0; k < top; k++) {
+        scale *= pyramid.scale();
+    }
+
+    const GridGraph& coarse = pyramid.level(top);
+    SearchCore<GridGraph> top_search(coarse);
+    SearchResult top_result = top_search.execute(coarse.node(initial.first / scale, initial.second / scale),
+                                                 coarse.node(target.first / scale, target.second / scale));
+    result.expanded = top_result.expanded;
+    result.peak_nodes = static_cast<std::size_t>(coarse.node_count());
+    if (!top_result.found) {
+        return result;
+    }
+    std::vector<std::pair<int, int>> path;
+    for (int node : top_result.path) {
+        path.push_back(coarse.coordinates(node));
+    }
+    float cost = top_result.cost;
+
+    for (int k = top - 1; k >= 0; k--) {
+        scale /= pyramid.scale();
+        const GridGraph& grid = pyramid.level(k);
+        const GridGraph& above = pyramid.level(k + 1);
+        std::pair<int, int> from(initial.first / scale, initial.second / scale);
+        std::pair<int, int> to(target.first / scale, target.second / scale);
+
+        bool found = false;
+        for (int attempt = 0, width = radius; attempt <= max_widenings && !found; attempt++, width *= 2) {
+            if (attempt > 0) {
+                result.widenings++;
+            }
+            // Repeated blocks are dropped by CorridorGraph.
+            std::vector<std::pair<int, int>> blocks;
+            for (const auto& p : path) {
+                for (int r = std::max(0, p.first - width); r <= std::min(above.row_count() - 1, p.first + width); r++) {
+                    for (int c = std::max(0, p.second - width); c <= std::min(above.column_count() - 1, p.second + width); c++) {
+                        if (above.passable(above.node(r, c))) {
+                            blocks.emplace_back(r, c);
+                        }
+                    }
+                }
+            }
+            CorridorGraph corridor(grid, pyramid.scale(), blocks);
+            SearchCore<CorridorGraph> search(corridor);
+            SearchResult level_result = search.execute(corridor.local(from.first, from.second),
+                                                       corridor.local(to.first, to.second));
+            result.expanded += level_result.expanded;
+            result.peak_nodes = std::max(result.peak_nodes, static_cast<std::size_t>(corridor.node_count()));
+            if (level_result.found) {
+                found = true;
+                cost = level_result.cost;
+                path.clear();
+                for (int node : level_result.path) {
+                    path.push_back(corridor.coordinates(node));
+                }
+            }
+        }
+        if (!found) {
+            result.widenings++;
+            SearchCore<GridGraph> search(grid);
+            SearchResult level_result = search.execute(grid.node(from.first, from.second), grid.node(to.first, to.second));
+            result.expanded += level_result.expanded;
+            result.peak_nodes = std::max(result.peak_nodes, static_cast<std::size_t>(grid.node_count()));
+            if (!level_result.found) {
+                return result;
+            }
+            cost = level_result.cost;
+            path.clear();
+            for (int node : level_result.path) {
+                path.push_back(grid.coordinates(node));
+            }
+        }
+    }
+
+    const GridGraph& finest = pyramid.level(0);
+    result.found = true;
+    result.cost = cost;
+    for (const auto& p : path) {
+        result.path.push_back(finest.node(p.first, p.second));
+    }
+    return result;
+}
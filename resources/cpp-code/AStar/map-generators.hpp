@@ -0,0 +1,240 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+// Seeded map generators in the data_matrix convention (cell cost, -1 for
+// walls). The same arguments always give the same map, with any standard
+// library: values are drawn from std::mt19937's output, which the standard
+// fixes, through the helpers below rather than the <random> distributions,
+// whose algorithms are implementation-defined. Every generator
+// uses costs of at least 1, so GridGraph's Manhattan heuristic stays
+// admissible on its maps. Non-positive sizes and ratios outside [0, 1]
+// throw std::invalid_argument.
+
+// Uniform integer in [0, bound), bound >= 1, without modulo bias.
+inline int generator_below(std::mt19937& rng, int bound) {
+    const std::uint32_t range = static_cast<std::uint32_t>(bound);
+    const std::uint32_t reject = (0u - range) % range;   // 2^32 mod range
+    while (true) {
+        std::uint32_t value = static_cast<std::uint32_t>(rng());
+        if (value >= reject) {
+            return static_cast<int>(value % range);
+        }
+    }
+}
+
+// Uniform double in [0, 1) with 53 random bits.
+inline double generator_unit(std::mt19937& rng) {
+    std::uint64_t high = static_cast<std::uint32_t>(rng()) >> 5;
+    std::uint64_t low = static_cast<std::uint32_t>(rng()) >> 6;
+    return static_cast<double>((high << 26) | low) * (1.0 / 9007199254740992.0);
+}
+
+// Perfect maze (one path between any two cells) carved by a randomized
+// depth-first search. Passages are `corridor` cells wide and separated by
+// one-cell walls; the outer border is wall.
+inline std::vector<std::vector<int>> maze_grid(int rows, int cols, unsigned seed, int corridor = 1) {
+    if (rows < 3 || cols < 3 || corridor < 1) {
+        throw std::invalid_argument("maze_grid: need at least 3x3 cells and corridor >= 1");
+    }
+    std::vector<std::vector<int>> data_matrix(rows, std::vector<int>(cols, -1));
+    const int pitch = corridor + 1;
+    const int maze_rows = (rows - 1) / pitch;
+    const int maze_cols = (cols - 1) / pitch;
+    auto open = [&](int r0, int c0, int height, int width) {
+        for (int r = r0; r < r0 + height; r++) {
+            for (int c = c0; c < c0 + width; c++) {
+                data_matrix[r][c] = 1;
+            }
+        }
+    };
+    std::mt19937 rng(seed);
+    std::vector<char> visited(static_cast<std::size_t>(maze_rows) * maze_cols, 0);
+    std::vector<std::pair<int, int>> stack = {{0, 0}};
+    visited[0] = 1;
+    open(1, 1, corridor, corridor);
+    const int dr[4] = {1, 0, -1, 0};
+    const int dc[4] = {0, 1, 0, -1};
+    while (!stack.empty()) {
+        auto [r, c] = stack.back();
+        int choices[4];
+        int count = 0;
+        for (int d = 0; d < 4; d++) {
+            int nr = r + dr[d];
+            int nc = c + dc[d];
+            if (nr >= 0 && nr < maze_rows && nc >= 0 && nc < maze_cols && !visited[nr * maze_cols + nc]) {
+                choices[count++] = d;
+            }
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int d = choices[generator_below(rng, count)];
+        int nr = r + dr[d];
+        int nc = c + dc[d];
+        visited[nr * maze_cols + nc] = 1;
+        // Open the next cell and the wall between the two.
+        open(1 + nr * pitch, 1 + nc * pitch, corridor, corridor);
+        open(1 + std::min(r, nr) * pitch + (dr[d] != 0 ? corridor : 0),
+             1 + std::min(c, nc) * pitch + (dc[d] != 0 ? corridor : 0),
+             dr[d] != 0 ? 1 : corridor, dc[d] != 0 ? 1 : corridor);
+        stack.emplace_back(nr, nc);
+    }
+    return data_matrix;
+}
+
+// Square rooms of `room_size` cells in a lattice of one-cell walls, like the
+// MovingAI room maps. Every wall between neighboring rooms gets a door of
+// `door_width` cells at a random place, and each wall is instead opened
+// completely with probability `open_ratio`.
+inline std::vector<std::vector<int>> rooms_grid(int rows, int cols, int room_size, unsigned seed,
+                                                int door_width = 2, double open_ratio = 0.1) {
+    if (rows < 1 || cols < 1) {
+        throw std::invalid_argument("rooms_grid: rows and cols must be positive");
+    }
+    if (room_size < 1 || door_width < 1 || door_width > room_size) {
+        throw std::invalid_argument("rooms_grid: need 1 <= door_width <= room_size");
+    }
+    if (!(open_ratio >= 0.0 && open_ratio <= 1.0)) {
+        throw std::invalid_argument("rooms_grid: open_ratio must be in [0, 1]");
+    }
+    std::vector<std::vector<int>> data_matrix(rows, std::vector<int>(cols, 1));
+    const int pitch = room_size + 1;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            if (r % pitch == room_size || c % pitch == room_size) {
+                data_matrix[r][c] = -1;
+            }
+        }
+    }
+    std::mt19937 rng(seed);
+    auto open_wall = [&]() {
+        return generator_unit(rng) < open_ratio;
+    };
+    auto door = [&]() {
+        return generator_below(rng, room_size - door_width + 1);
+    };
+    auto carve = [&](int r, int c) {
+        if (r < rows && c < cols) {
+            data_matrix[r][c] = 1;
+        }
+    };
+    for (int room_r = 0; room_r * pitch < rows; room_r++) {
+        for (int room_c = 0; room_c * pitch < cols; room_c++) {
+            int top = room_r * pitch;
+            int left = room_c * pitch;
+            // The wall below this room, then the wall to its right.
+            bool whole = open_wall();
+            int offset = whole ? 0 : door();
+            for (int i = offset; i < (whole ? room_size : offset + door_width); i++) {
+                carve(top + room_size, left + i);
+            }
+            whole = open_wall();
+            offset = whole ? 0 : door();
+            for (int i = offset; i < (whole ? room_size : offset + door_width); i++) {
+                carve(top + i, left + room_size);
+            }
+        }
+    }
+    return data_matrix;
+}
+
+// Weighted terrain from value noise: random values on lattices every 32, 8
+// and 2 cells, bilinearly interpolated and summed with halving weights.
+// The result is scaled to costs 1 to max_cost, and the lowest
+// `wall_ratio` of it (by noise value, so walls form lakes rather than
+// specks) becomes -1.
+inline std::vector<std::vector<int>> noise_terrain_grid(int rows, int cols, unsigned seed, int max_cost = 8,
+                                                        double wall_ratio = 0.15) {
+    if (rows < 1 || cols < 1) {
+        throw std::invalid_argument("noise_terrain_grid: rows and cols must be positive");
+    }
+    if (max_cost < 1) {
+        throw std::invalid_argument("noise_terrain_grid: max_cost must be at least 1");
+    }
+    if (!(wall_ratio >= 0.0 && wall_ratio <= 1.0)) {
+        throw std::invalid_argument("noise_terrain_grid: wall_ratio must be in [0, 1]");
+    }
+    std::mt19937 rng(seed);
+    std::vector<double> noise(static_cast<std::size_t>(rows) * cols, 0.0);
+    double amplitude = 1.0;
+    for (int spacing : {32, 8, 2}) {
+        int lattice_rows = rows / spacing + 2;
+        int lattice_cols = cols / spacing + 2;
+        std::vector<double> lattice(static_cast<std::size_t>(lattice_rows) * lattice_cols);
+        for (double& value : lattice) {
+            value = generator_unit(rng);
+        }
+        for (int r = 0; r < rows; r++) {
+            int lr = r / spacing;
+            double fr = static_cast<double>(r % spacing) / spacing;
+            for (int c = 0; c < cols; c++) {
+                int lc = c / spacing;
+                double fc = static_cast<double>(c % spacing) / spacing;
+                const double* row0 = &lattice[static_cast<std::size_t>(lr) * lattice_cols + lc];
+                const double* row1 = row0 + lattice_cols;
+                double top = row0[0] + (row0[1] - row0[0]) * fc;
+                double bottom = row1[0] + (row1[1] - row1[0]) * fc;
+                noise[static_cast<std::size_t>(r) * cols + c] += amplitude * (top + (bottom - top) * fr);
+            }
+        }
+        amplitude /= 2;
+    }
+    std::vector<double> sorted = noise;
+    std::sort(sorted.begin(), sorted.end());
+    double low = sorted.front();
+    double high = sorted.back();
+    double wall_below = sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(wall_ratio * sorted.size()))];
+    std::vector<std::vector<int>> data_matrix(rows, std::vector<int>(cols));
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            double value = noise[static_cast<std::size_t>(r) * cols + c];
+            if (wall_ratio > 0 && value < wall_below) {
+                data_matrix[r][c] = -1;
+                continue;
+            }
+            double t = high > low ? (value - low) / (high - low) : 0.0;
+            data_matrix[r][c] = 1 + static_cast<int>(std::lround(t * (max_cost - 1)));
+        }
+    }
+    return data_matrix;
+}
+
+// Large open field of cost 1 with scattered rectangular obstacles of up to
+// `max_obstacle` cells a side, placed until about `obstacle_ratio` of the
+// cells are walls.
+inline std::vector<std::vector<int>> open_field_grid(int rows, int cols, unsigned seed, double obstacle_ratio = 0.05,
+                                                     int max_obstacle = 8) {
+    if (rows < 1 || cols < 1 || max_obstacle < 1) {
+        throw std::invalid_argument("open_field_grid: rows, cols and max_obstacle must be positive");
+    }
+    if (!(obstacle_ratio >= 0.0 && obstacle_ratio <= 1.0)) {
+        throw std::invalid_argument("open_field_grid: obstacle_ratio must be in [0, 1]");
+    }
+    std::vector<std::vector<int>> data_matrix(rows, std::vector<int>(cols, 1));
+    std::mt19937 rng(seed);
+    const double target = obstacle_ratio * rows * cols;
+    double walls = 0;
+    while (walls < target) {
+        int r0 = generator_below(rng, rows);
+        int c0 = generator_below(rng, cols);
+        int height = 1 + generator_below(rng, max_obstacle);
+        int width = 1 + generator_below(rng, max_obstacle);
+        for (int r = r0; r < std::min(rows, r0 + height); r++) {
+            for (int c = c0; c < std::min(cols, c0 + width); c++) {
+                if (data_matrix[r][c] != -1) {
+                    data_matrix[r][c] = -1;
+                    walls++;
+                }
+            }
+        }
+    }
+    return data_matrix;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+// The 10x10 map used by the original sample.
+inline std::vector<std::vector<int>> demo_grid() {
+    return {
+        { 0,  2, -1,  0,  2,  6,  5,  5,  4,  6},
+        { 5, -1, -1,  4,  1,  1,  1,  5,  3,  5},
+        { 2,  6,  8, -1,  5,  2,  8,  4,  0,  0},
+        { 1,  0,  5,  5, -1,  2,  2,  1,  0,  7},
+        { 0,  6,  5,  0,  6,  6,  7,  6,  0,  1},
+        { 4,  3,  8,  7,  3,  4,  8,  6,  4,  2},
+        { 1,  3,  5,  2,  6,  2,  4,  6,  8,  1},
+        { 2,  8,  0,  5,  7,  1,  6, -1,  8,  1},
+        { 7,  5,  0,  2,  4, -1,  0,  3,  0,  5},
+        { 3,  3,  6,  0,  6,  5,  7,  4,  6,  5}
+    };
+}
+
+// Reads a grid written the way main() prints it: one row per line, cells
+// separated by whitespace, -1 for walls. Any other cell must be a
+// non-negative integer cost: the searches and DaryOpenList's key packing
+// assume costs never go below zero. The name "demo" loads demo_grid().
+inline std::vector<std::vector<int>> load_grid_text(const std::string& path) {
+    if (path == "demo") {
+        return demo_grid();
+    }
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open map " + path);
+    }
+    std::vector<std::vector<int>> data_matrix;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        std::istringstream cells(line);
+        std::vector<int> row;
+        int value;
+        while (cells >> value) {
+            if (value < -1) {
+                throw std::runtime_error("negative cost on line " + std::to_string(line_number) + " of map " + path);
+            }
+            row.push_back(value);
+        }
+        if (!cells.eof()) {
+            throw std::runtime_error("bad cell on line " + std::to_string(line_number) + " of map " + path);
+        }
+        if (row.empty()) {
+            continue;
+        }
+        if (!data_matrix.empty() && row.size() != data_matrix[0].size()) {
+            throw std::runtime_error("ragged row in map " + path);
+        }
+        data_matrix.push_back(std::move(row));
+    }
+    if (data_matrix.empty()) {
+        throw std::runtime_error("empty map " + path);
+    }
+    return data_matrix;
+}
+
+// Costs given to MovingAI terrain characters. '.' and 'G' are ground, 'S'
+// swamp, 'W' water, '@', 'O' and 'T' are always walls. Water can only be
+// entered from water in the benchmark's rules, which a cell cost cannot
+// express, so it is a wall unless given a cost here.
+struct MovingAiCosts {
+    int ground = 1;
+    int swamp = 1;
+    int water = -1;
+};
+
+// Reads a MovingAI .map file ("type octile", "height H", "width W", "map",
+// then H rows of W characters) into the data_matrix convention.
+inline std::vector<std::vector<int>> load_movingai_map(const std::string& path,
+                                                       const MovingAiCosts& costs = MovingAiCosts()) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open map " + path);
+    }
+    int height = -1;
+    int width = -1;
+    std::string word;
+    while (file >> word && word != "map") {
+        if (word == "height") {
+            file >> height;
+        } else if (word == "width") {
+            file >> width;
+        } else if (word == "type") {
+            file >> word;
+        } else {
+            throw std::runtime_error("unexpected '" + word + "' in map header " + path);
+        }
+    }
+    if (!file || height <= 0 || width <= 0) {
+        throw std::runtime_error("bad map header " + path);
+    }
+    std::vector<std::vector<int>> data_matrix(height, std::vector<int>(width));
+    std::string line;
+    std::getline(file, line);
+    for (int r = 0; r < height; r++) {
+        if (!std::getline(file, line)) {
+            throw std::runtime_error("map " + path + " ends before row " + std::to_string(r));
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (static_cast<int>(line.size()) != width) {
+            throw std::runtime_error("row " + std::to_string(r) + " of map " + path + " is not " +
+                                     std::to_string(width) + " cells wide");
+        }
+        for (int c = 0; c < width; c++) {
+            switch (line[c]) {
+                case '.': case 'G': data_matrix[r][c] = costs.ground; break;
+                case 'S': data_matrix[r][c] = costs.swamp; break;
+                case 'W': data_matrix[r][c] = costs.water; break;
+                case '@': case 'O': case 'T': data_matrix[r][c] = -1; break;
+                default:
+                    throw std::runtime_error(std::string("unknown terrain '") + line[c] + "' in map " + path);
+            }
+        }
+    }
+    return data_matrix;
+}
+
+// One line of a MovingAI .scen file. The file gives x (column) before y
+// (row); start and goal here are (row, col) like everywhere else.
+// optimal_length is the benchmark's octile distance: 8-connected moves
+// costing 1 and sqrt(2), no corner cutting, every passable cell alike. It
+// is not the cost of a 4-connected path and does not see our cell costs.
+// Loading rejects start and goal cells outside width x height.
+struct ScenarioQuery {
+    int bucket;
+    std::string map;   // as written in the file, usually relative to the maps directory
+    int width;
+    int height;
+    std::pair<int, int> start;
+    std::pair<int, int> goal;
+    double optimal_length;
+};
+
+inline std::vector<ScenarioQuery> load_movingai_scenario(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open scenario " + path);
+    }
+    std::vector<ScenarioQuery> queries;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.empty() || line.compare(0, 7, "version") == 0) {
+            continue;
+        }
+        // Fields are tab-separated, so map names may hold spaces; hand-edited
+        // files with spaces between fields are accepted too.
+        std::vector<std::string> fields;
+        std::istringstream tabs(line);
+        std::string field;
+        while (std::getline(tabs, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 9) {
+            fields.clear();
+            std::istringstream words(line);
+            while (words >> field) {
+                fields.push_back(field);
+            }
+        }
+        ScenarioQuery query;
+        try {
+            if (fields.size() != 9) {
+                throw std::invalid_argument("field count");
+            }
+            query.bucket = std::stoi(fields[0]);
+            query.map = fields[1];
+            query.width = std::stoi(fields[2]);
+            query.height = std::stoi(fields[3]);
+            query.start = {std::stoi(fields[5]), std::stoi(fields[4])};
+            query.goal = {std::stoi(fields[7]), std::stoi(fields[6])};
+            query.optimal_length = std::stod(fields[8]);
+            auto inside = [&](std::pair<int, int> cell) {
+                return cell.first >= 0 && cell.first < query.height && cell.second >= 0 && cell.second < query.width;
+            };
+            if (!inside(query.start) || !inside(query.goal)) {
+                throw std::invalid_argument("cell outside the map");
+            }
+        } catch (const std::exception&) {
+            throw std::runtime_error("bad line " + std::to_string(line_number) + " in scenario " + path);
+        }
+        queries.push_back(std::move(query));
+    }
+    return queries;
+}
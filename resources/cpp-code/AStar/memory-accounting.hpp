@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Byte and call counts of one account, or of the whole process.
+struct AllocationStats {
+    std::size_t live_bytes = 0;
+    std::size_t peak_bytes = 0;
+    std::size_t allocated_bytes = 0;   // total over the account's lifetime
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+};
+
+// Allocation counters for one search, fed by CountingAllocator. An account
+// belongs to one thread, so its counters are plain integers and the
+// allocator hot path touches no shared state. flush() adds what changed
+// since the previous flush to the process-wide totals, which are atomic;
+// the owner calls it once per query, and the destructor calls it for
+// whatever is left.
+class MemoryAccount {
+private:
+    AllocationStats stats;
+    AllocationStats flushed;            // the part of stats already in the totals
+    std::size_t peak_since_flush = 0;   // highest live_bytes since the last flush
+
+    struct ProcessTotals {
+        std::atomic<std::size_t> live_bytes{0};
+        std::atomic<std::size_t> peak_bytes{0};
+        std::atomic<std::size_t> allocated_bytes{0};
+        std::atomic<std::size_t> allocations{0};
+        std::atomic<std::size_t> deallocations{0};
+    };
+
+    static ProcessTotals& totals() {
+        static ProcessTotals process;
+        return process;
+    }
+
+public:
+    MemoryAccount() = default;
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    ~MemoryAccount() {
+        flush();
+    }
+
+    void on_allocate(std::size_t bytes) {
+        stats.live_bytes += bytes;
+        stats.allocated_bytes += bytes;
+        stats.allocations++;
+        if (stats.live_bytes > stats.peak_bytes) {
+            stats.peak_bytes = stats.live_bytes;
+        }
+        if (stats.live_bytes > peak_since_flush) {
+            peak_since_flush = stats.live_bytes;
+        }
+    }
+
+    void on_deallocate(std::size_t bytes) {
+        stats.live_bytes -= bytes;
+        stats.deallocations++;
+    }
+
+    // The process peak assumes the other accounts' live bytes did not
+    // change since this account last flushed.
+    void flush() {
+        ProcessTotals& process = totals();
+        std::size_t before = process.live_bytes.fetch_add(stats.live_bytes - flushed.live_bytes,
+                                                          std::memory_order_relaxed);
+        std::size_t peak = before + (peak_since_flush - flushed.live_bytes);
+        std::size_t seen = process.peak_bytes.load(std::memory_order_relaxed);
+        while (peak > seen && !process.peak_bytes.compare_exchange_weak(seen, peak, std::memory_order_relaxed)) {
+        }
+        process.allocated_bytes.fetch_add(stats.allocated_bytes - flushed.allocated_bytes, std::memory_order_relaxed);
+        process.allocations.fetch_add(stats.allocations - flushed.allocations, std::memory_order_relaxed);
+        process.deallocations.fetch_add(stats.deallocations - flushed.deallocations, std::memory_order_relaxed);
+        flushed = stats;
+        peak_since_flush = stats.live_bytes;
+    }
+
+    const AllocationStats& current() const {
+        return stats;
+    }
+
+    // Every account in the process added together, as of each account's
+    // last flush; peak_bytes is the highest combined live size seen.
+    static AllocationStats process() {
+        const ProcessTotals& process = totals();
+        AllocationStats sum;
+        sum.live_bytes = process.live_bytes.load(std::memory_order_relaxed);
+        sum.peak_bytes = process.peak_bytes.load(std::memory_order_relaxed);
+        sum.allocated_bytes = process.allocated_bytes.load(std::memory_order_relaxed);
+        sum.allocations = process.allocations.load(std::memory_order_relaxed);
+        sum.deallocations = process.deallocations.load(std::memory_order_relaxed);
+        return sum;
+    }
+};
+
+// std::allocator that reports every allocation to a MemoryAccount. Works
+// for containers and, through std::allocate_shared, for shared_ptr objects
+// together with their control blocks. The account must outlive every
+// allocation made through it.
+template <class T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    MemoryAccount* account;
+
+    explicit CountingAllocator(MemoryAccount* account_) noexcept : account(account_) {}
+
+    template <class U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept : account(other.account) {}
+
+    T* allocate(std::size_t n) {
+        T* memory = std::allocator<T>().allocate(n);
+        account->on_allocate(n * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, std::size_t n) noexcept {
+        account->on_deallocate(n * sizeof(T));
+        std::allocator<T>().deallocate(memory, n);
+    }
+};
+
+template <class T, class U>
+bool operator==(const CountingAllocator<T>& a, const CountingAllocator<U>& b) {
+    return a.account == b.account;
+}
+
+template <class T, class U>
+bool operator!=(const CountingAllocator<T>& a, const CountingAllocator<U>& b) {
+    return a.account != b.account;
+}
@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "bfs.hpp"
+#include "cooperative-bfs.hpp"
+#include "csr-graph.hpp"
+#include "expansion-trace.hpp"
+#include "grid-graph.hpp"
+#include "map-io.hpp"
+#include "query-pipeline.hpp"
+#include "search-core.hpp"
+#include "sma-star.hpp"
+
+// Prints each agent's plan and checks that no two agents share a cell at
+// any step; an agent without a plan stays on its start cell throughout.
+bool print_cooperative(const std::vector<std::vector<int>>& map_grid,
+                       const std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>& agents) {
+    ReservationTable reservations;
+    auto plans = plan_cooperative(map_grid, agents, reservations, 100);
+    std::size_t steps = 1;
+    for (size_t agent = 0; agent < plans.size(); agent++) {
+        std::cout << "Agent " << agent << ":";
+        steps = std::max(steps, plans[agent].first.size());
+        if (plans[agent].first.empty()) {
+            std::cout << " no plan, stays at (" << agents[agent].first.first << "," << agents[agent].first.second
+                      << ")" << std::endl;
+            continue;
+        }
+        for (const auto& p : plans[agent].first) {
+            std::cout << " (" << p.first << "," << p.second << ")";
+        }
+        std::cout << " cost " << plans[agent].second << std::endl;
+    }
+    auto position = [&](size_t agent, size_t t) {
+        const auto& path = plans[agent].first;
+        return path.empty() ? agents[agent].first : path[std::min(t, path.size() - 1)];
+    };
+    for (size_t t = 0; t < steps; t++) {
+        for (size_t a = 0; a < plans.size(); a++) {
+            for (size_t b = a + 1; b < plans.size(); b++) {
+                if (position(a, t) == position(b, t)) {
+                    std::cout << "Conflict: agents " << a << " and " << b << " at t = " << t << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    std::cout << "No conflicts" << std::endl;
+    return true;
+}
+
+bool run_cooperative(const std::vector<std::vector<int>>& map_grid) {
+    bool ok = print_cooperative(map_grid, {
+        {{0, 0}, {9, 9}},
+        {{9, 9}, {0, 0}},
+        {{0, 9}, {9, 0}},
+        {{9, 0}, {0, 9}}
+    });
+    // The first agent's goal is a wall, so it cannot be routed and must
+    // block the corridor the second agent would otherwise take.
+    std::cout << "Unroutable first agent:" << std::endl;
+    return print_cooperative(map_grid, {
+        {{3, 6}, {0, 2}},
+        {{0, 0}, {9, 9}}
+    }) && ok;
+}
+
+template <class Graph>
+void print_core_result(const char* name, const GridGraph& grid, const Graph& graph) {
+    SearchCore<Graph> search(graph);
+    SearchResult result = search.execute(grid.node(0, 0), grid.node(9, 9));
+    std::cout << name << ":";
+    if (!result.found) {
+        std::cout << " no path" << std::endl;
+        return;
+    }
+    for (int node : result.path) {
+        auto p = grid.coordinates(node);
+        std::cout << " (" << p.first << "," << p.second << ")";
+    }
+    std::cout << " cost " << result.cost << " expanded " << result.expanded << std::endl;
+}
+
+void run_core(const std::vector<std::vector<int>>& map_grid) {
+    GridGraph grid(map_grid);
+    CsrGraph csr = grid_to_csr(map_grid);
+    print_core_result("Grid", grid, grid);
+    print_core_result("CSR", grid, csr);
+}
+
+void run_bounded(const std::vector<std::vector<int>>& map_grid, std::size_t budget) {
+    GridGraph grid(map_grid);
+    MemoryBoundedSearch<GridGraph> search(grid, budget);
+    BoundedSearchResult result = search.execute(grid.node(0, 0), grid.node(9, 9));
+    std::cout << "Budget " << budget << " nodes:";
+    if (!result.found) {
+        std::cout << " no path";
+    } else {
+        for (int node : result.path) {
+            auto p = grid.coordinates(node);
+            std::cout << " (" << p.first << "," << p.second << ")";
+        }
+        std::cout << " cost " << result.cost;
+    }
+    std::cout << " peak " << result.peak_nodes << (result.budget_hit ? " budget hit" : "") << std::endl;
+}
+
+// The demo query with an expansion budget, then cancelled before it
+// starts; both come back as partial paths towards (9,9).
+void run_deadline(const std::vector<std::vector<int>>& map_grid, std::size_t expansions) {
+    GridGraph grid(map_grid);
+    SearchCore<GridGraph> search(grid);
+    CancellationToken token;
+    token.cancel();
+    SearchLimits cancelled;
+    cancelled.token = &token;
+    std::pair<std::string, SearchLimits> runs[] = {
+        {"Budget " + std::to_string(expansions) + " expansions", SearchLimits::expansions(expansions)},
+        {"Cancelled", cancelled}
+    };
+    for (const auto& run : runs) {
+        SearchResult result = search.execute(grid.node(0, 0), grid.node(9, 9), run.second);
+        std::cout << run.first << ":";
+        for (int node : result.path) {
+            auto p = grid.coordinates(node);
+            std::cout << " (" << p.first << "," << p.second << ")";
+        }
+        std::cout << " cost " << result.cost << " expanded " << result.expanded
+                  << (result.found ? " found" : result.partial ? " partial" : " no path") << std::endl;
+    }
+}
+
+void print_allocation_stats(const char* name, const AllocationStats& stats) {
+    std::cout << name << ": " << stats.allocations << " allocations, " << stats.deallocations << " frees, "
+              << stats.allocated_bytes << " bytes allocated, peak " << stats.peak_bytes << " bytes, live "
+              << stats.live_bytes << " bytes" << std::endl;
+}
+
+// One BFS per goal, each reporting its own allocations, then the totals
+// of the whole process.
+void run_memory(const std::vector<std::vector<int>>& map_grid) {
+    auto start_node = std::make_shared<DataPoint>(std::make_pair(0, 0), 0, 0);
+    for (auto goal : {std::make_pair(9, 9), std::make_pair(5, 5), std::make_pair(0, 9)}) {
+        BFS bfs(map_grid, start_node, std::make_shared<DataPoint>(goal, 0, 0));
+        auto result = bfs.execute();
+        std::string name = "(0,0) -> (" + std::to_string(goal.first) + "," + std::to_string(goal.second) + ") cost " +
+                           std::to_string(static_cast<int>(result.second));
+        print_allocation_stats(name.c_str(), bfs.memory());
+    }
+    print_allocation_stats("process", MemoryAccount::process());
+}
+
+// The demo query and two more, each on its own thread, traced into one
+// file for trace-decode.
+int run_trace(const std::vector<std::vector<int>>& map_grid, const std::string& path) {
+    try {
+        TraceWriter writer(path);
+        auto start_node = std::make_shared<DataPoint>(std::make_pair(0, 0), 0, 0);
+        std::vector<std::thread> threads;
+        for (auto goal : {std::make_pair(9, 9), std::make_pair(5, 5), std::make_pair(0, 9)}) {
+            threads.emplace_back([&, goal]() {
+                BFS bfs(map_grid, start_node, std::make_shared<DataPoint>(goal, 0, 0));
+                bfs.set_trace(&writer.ring());
+                bfs.execute();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        writer.close();
+        std::cout << writer.events_written() << " events written to " << path << ", "
+                  << writer.events_dropped() << " dropped" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Answers a stream of queries against one map: --stream MAP [QUERIES]
+// [OUTPUT] [THREADS] [--paths], with "-" for stdin and stdout. Progress
+// goes to stderr so the results stay the only thing on stdout.
+int run_stream(int argc, char* argv[]) {
+    std::vector<std::string> args;
+    StreamOptions options;
+    for (int i = 2; i < argc; i++) {
+        if (std::string(argv[i]) == "--paths") {
+            options.paths = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    if (args.empty()) {
+        std::cerr << "usage: " << argv[0] << " --stream MAP [QUERIES|-] [OUTPUT|-] [THREADS] [--paths]" << std::endl;
+        return 2;
+    }
+    options.threads = args.size() > 3 ? std::atoi(args[3].c_str()) : 0;
+    try {
+        GridGraph grid(load_grid_text(args[0]));
+        int in_fd = open_stream(args.size() > 1 ? args[1] : "-", false);
+        int out_fd = open_stream(args.size() > 2 ? args[2] : "-", true);
+        auto begin = std::chrono::steady_clock::now();
+        StreamStats stats = QueryPipeline(grid, options).run(in_fd, out_fd);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cerr << stats.queries << " queries, " << stats.found << " found, " << stats.bad << " bad, "
+                  << seconds * 1e3 << " ms, " << (seconds > 0 ? stats.queries / seconds : 0.0) << " queries/s"
+                  << std::endl;
+        if (out_fd != STDOUT_FILENO) {
+            close(out_fd);
+        }
+        if (in_fd != STDIN_FILENO) {
+            close(in_fd);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--stream") {
+        return run_stream(argc, argv);
+    }
+
+    std::vector<std::vector<int>> map_grid = demo_grid();
+
+    std::cout << "Map Grid:" << std::endl;
+    for (const auto& row : map_grid) {
+        for (int val : row) {
+            std::cout << val << " ";
+        }
+        std::cout << std::endl;
+    }
+
+    // --perf[=N] may appear anywhere: it turns on hardware counters for
+    // the benchmarks and is dropped before the positional arguments.
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--perf" || arg.rfind("--perf=", 0) == 0) {
+            benchmark_perf_period() = arg.size() > 7 ? static_cast<std::uint32_t>(std::strtoul(arg.c_str() + 7, nullptr, 10)) : 1;
+            if (benchmark_perf_period() == 0) {
+                benchmark_perf_period() = 1;
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--cooperative") {
+        return run_cooperative(map_grid) ? 0 : 1;
+    }
+    if (mode == "--core") {
+        run_core(map_grid);
+        return 0;
+    }
+    if (mode == "--deadline") {
+        run_deadline(map_grid, argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20);
+        return 0;
+    }
+    if (mode == "--memory") {
+        run_memory(map_grid);
+        return 0;
+    }
+    if (mode == "--trace") {
+        return run_trace(map_grid, argc > 2 ? argv[2] : "search.trace");
+    }
+    if (mode == "--bounded") {
+        run_bounded(map_grid, argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 40);
+        return 0;
+    }
+    if (mode == "--bench-layout") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 2048;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+        run_layout_benchmark(size, queries);
+        return 0;
+    }
+    if (mode == "--bench-open-list") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 1024;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+        run_open_list_benchmark(size, queries);
+        return 0;
+    }
+    if (mode == "--bench-pyramid") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 2048;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 100;
+        run_pyramid_benchmark(size, queries);
+        return 0;
+    }
+    if (mode == "--bench-sssp") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 2048;
+        int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+        run_sssp_benchmark(size, threads);
+        return 0;
+    }
+    if (mode == "--bench-goal-bounding") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 128;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 1000;
+        int threads = argc > 4 ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+        run_goal_bounding_benchmark(size, queries, threads);
+        return 0;
+    }
+    if (mode == "--bench-swamps") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 256;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 1000;
+        int max_region = argc > 4 ? std::atoi(argv[4]) : 8;
+        run_region_pruning_benchmark(size, queries, max_region);
+        return 0;
+    }
+    if (mode == "--bench-rcu") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 512;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 500;
+        int threads = argc > 4 ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+        run_versioned_grid_benchmark(size, queries, threads);
+        return 0;
+    }
+    if (mode == "--bench-multi-goal") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 512;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 100;
+        int goals = argc > 4 ? std::atoi(argv[4]) : 16;
+        run_multi_goal_benchmark(size, queries, goals);
+        return 0;
+    }
+    if (mode == "--bench-goal-cache") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 256;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 2000;
+        int goals = argc > 4 ? std::atoi(argv[4]) : 8;
+        int cached = argc > 5 ? std::atoi(argv[5]) : 6;
+        run_goal_cache_benchmark(size, queries, goals, cached);
+        return 0;
+    }
+    if (mode == "--bench-maps") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 512;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+        run_map_suite_benchmark(size, queries);
+        return 0;
+    }
+    if (mode == "--bench-rsr") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 512;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+        run_rectangle_benchmark(size, queries);
+        return 0;
+    }
+    if (mode == "--verify-rsr") {
+        int seeds = argc > 2 ? std::atoi(argv[2]) : 6;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 60;
+        return verify_rectangle_search(seeds, queries) ? 0 : 1;
+    }
+    if (mode == "--bench-simd") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 1024;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+        return run_simd_benchmark(size, queries) ? 0 : 1;
+    }
+    if (mode == "--scen") {
+        if (argc < 3) {
+            std::cerr << "usage: " << argv[0] << " --scen FILE.scen [LIMIT]" << std::endl;
+            return 2;
+        }
+        try {
+            return run_scenario_benchmark(argv[2], argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (mode == "--bench-batch") {
+        int size = argc > 2 ? std::atoi(argv[2]) : 1024;
+        int queries = argc > 3 ? std::atoi(argv[3]) : 200;
+        int threads = argc > 4 ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+        run_batch_benchmark(size, queries, threads);
+        return 0;
+    }
+
+    auto start_node = std::make_shared<DataPoint>(std::make_pair(0,0), 0, 0);
+    auto goal_node = std::make_shared<DataPoint>(std::make_pair(9,9), 0, 0);
+
+    BFS bfs(map_grid, start_node, goal_node);
+    auto result = bfs.execute();
+    if (!result.first.empty()) {
+        std::cout << "Path found:" << std::endl;
+        for (const auto& p : result.first) {
+            std::cout << "(" << p.first << "," << p.second << ")" << std::endl;
+        }
+    } else {
+        std::cout << "No path found." << std::endl;
+    }
+
+    return 0;
+}
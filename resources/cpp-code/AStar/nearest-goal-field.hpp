@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+// Manhattan distance from every cell to the nearest of a set of goal
+// cells, walls ignored: the same value as the minimum of the grid's
+// heuristic over the goals, but looked up in O(1) instead of O(goals).
+// Built by a two-pass L1 distance transform in O(cells), independent of
+// how many goals there are, so it pays off for large goal sets or for a
+// fixed set (depots, exits) shared by many queries. Works with any grid
+// graph that has row_count(), column_count() and row-major node ids.
+class NearestGoalField {
+private:
+    int cols;
+    std::vector<int> distance;
+
+public:
+    template <class Grid>
+    NearestGoalField(const Grid& grid, const std::vector<int>& goals) : cols(grid.column_count()) {
+        const int rows = grid.row_count();
+        const int far = std::numeric_limits<int>::max() / 2;
+        distance.assign(static_cast<std::size_t>(rows) * cols, far);
+        for (int goal : goals) {
+            distance[goal] = 0;
+        }
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int& d = distance[r * cols + c];
+                if (r > 0) {
+                    d = std::min(d, distance[(r - 1) * cols + c] + 1);
+                }
+                if (c > 0) {
+                    d = std::min(d, distance[r * cols + c - 1] + 1);
+                }
+            }
+        }
+        for (int r = rows - 1; r >= 0; r--) {
+            for (int c = cols - 1; c >= 0; c--) {
+                int& d = distance[r * cols + c];
+                if (r + 1 < rows) {
+                    d = std::min(d, distance[(r + 1) * cols + c] + 1);
+                }
+                if (c + 1 < cols) {
+                    d = std::min(d, distance[r * cols + c + 1] + 1);
+                }
+            }
+        }
+    }
+
+    float heuristic(int node) const {
+        return static_cast<float>(distance[node]);
+    }
+};
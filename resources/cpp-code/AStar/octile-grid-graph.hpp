@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+// 8-connected view of a data_matrix grid under the MovingAI benchmark
+// rules, so SearchCore can reproduce a .scen file's optimal lengths:
+// straight moves cost 1 and diagonal ones sqrt(2) whatever the cells
+// hold, and a diagonal move needs both cells it passes between to be
+// open (no corner cutting). -1 cells are walls. Node ids match GridGraph;
+// edges come straight first (down, right, up, left), then diagonals.
+class OctileGridGraph {
+private:
+    int rows;
+    int cols;
+    std::vector<char> open;
+
+public:
+    static constexpr float diagonal = 1.41421356f;
+
+    explicit OctileGridGraph(const std::vector<std::vector<int>>& data_matrix)
+        : rows(static_cast<int>(data_matrix.size())),
+          cols(data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size())) {
+        open.reserve(static_cast<size_t>(rows) * cols);
+        for (const auto& row : data_matrix) {
+            for (int value : row) {
+                open.push_back(value != -1);
+            }
+        }
+    }
+
+    int node_count() const {
+        return rows * cols;
+    }
+
+    int row_count() const {
+        return rows;
+    }
+
+    int column_count() const {
+        return cols;
+    }
+
+    int node(int r, int c) const {
+        return r * cols + c;
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        return {node / cols, node % cols};
+    }
+
+    bool passable(int node) const {
+        return open[node];
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        int r = node / cols;
+        int c = node % cols;
+        bool down = r + 1 < rows && open[node + cols];
+        bool right = c + 1 < cols && open[node + 1];
+        bool up = r > 0 && open[node - cols];
+        bool left = c > 0 && open[node - 1];
+        if (down) {
+            visit(node + cols, 1.0f);
+        }
+        if (right) {
+            visit(node + 1, 1.0f);
+        }
+        if (up) {
+            visit(node - cols, 1.0f);
+        }
+        if (left) {
+            visit(node - 1, 1.0f);
+        }
+        if (down && right && open[node + cols + 1]) {
+            visit(node + cols + 1, diagonal);
+        }
+        if (up && right && open[node - cols + 1]) {
+            visit(node - cols + 1, diagonal);
+        }
+        if (up && left && open[node - cols - 1]) {
+            visit(node - cols - 1, diagonal);
+        }
+        if (down && left && open[node + cols - 1]) {
+            visit(node + cols - 1, diagonal);
+        }
+    }
+
+    // Octile distance, exact on an open map.
+    float heuristic(int node, int target) const {
+        int dr = std::abs(node / cols - target / cols);
+        int dc = std::abs(node % cols - target % cols);
+        return static_cast<float>(std::max(dr, dc) - std::min(dr, dc)) + diagonal * std::min(dr, dc);
+    }
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+
+// Open-list policies for SearchCore. Each one is a min-priority queue of
+// (f, node) entries with the same interface:
+//
+//     void clear();
+//     bool empty() const;
+//     void push(float key, int node);
+//     std::pair<float, int> pop();   // removes and returns the minimum
+//
+// Stale entries are left in place and skipped by the search, so none of
+// them needs decrease-key. All of them order equal keys by node id, which
+// makes every policy expand nodes in exactly the same order.
+
+// std::push_heap/pop_heap over (f, node) pairs; what SearchCore always used.
+class BinaryOpenList {
+private:
+    std::vector<std::pair<float, int>> entries;
+
+public:
+    void clear() {
+        entries.clear();
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    void push(float key, int node) {
+        entries.emplace_back(key, node);
+        std::push_heap(entries.begin(), entries.end(), std::greater<>());
+    }
+
+    std::pair<float, int> pop() {
+        std::pop_heap(entries.begin(), entries.end(), std::greater<>());
+        std::pair<float, int> top = entries.back();
+        entries.pop_back();
+        return top;
+    }
+};
+
+// Implicit d-ary heap with keys stored inline next to node ids. Each entry
+// is one 64-bit word, the key's bits above the node id, so an entry
+// comparison is a single integer compare; this relies on f never being
+// negative, where IEEE order and unsigned order agree. A wider node also
+// means a shallower heap whose children sit side by side: with Arity 8,
+// the children of a slot are 64 contiguous bytes.
+template <int Arity>
+class DaryOpenList {
+    static_assert(Arity >= 2, "a heap needs at least two children per slot");
+
+private:
+    std::vector<std::uint64_t> entries;
+
+    static std::uint64_t pack(float key, int node) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return (static_cast<std::uint64_t>(bits) << 32) | static_cast<std::uint32_t>(node);
+    }
+
+    static std::pair<float, int> unpack(std::uint64_t entry) {
+        std::uint32_t bits = static_cast<std::uint32_t>(entry >> 32);
+        float key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return {key, static_cast<int>(static_cast<std::uint32_t>(entry))};
+    }
+
+public:
+    void clear() {
+        entries.clear();
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    void push(float key, int node) {
+        std::uint64_t entry = pack(key, node);
+        std::size_t i = entries.size();
+        entries.push_back(entry);
+        while (i > 0) {
+            std::size_t parent = (i - 1) / Arity;
+            if (entries[parent] <= entry) {
+                break;
+            }
+            entries[i] = entries[parent];
+            i = parent;
+        }
+        entries[i] = entry;
+    }
+
+    std::pair<float, int> pop() {
+        std::uint64_t top = entries.front();
+        std::uint64_t last = entries.back();
+        entries.pop_back();
+        const std::size_t size = entries.size();
+        if (size > 0) {
+            std::size_t i = 0;
+            while (true) {
+                std::size_t first = Arity * i + 1;
+                if (first >= size) {
+                    break;
+                }
+                std::size_t end = std::min(first + Arity, size);
+                std::size_t best = first;
+                for (std::size_t child = first + 1; child < end; child++) {
+                    if (entries[child] < entries[best]) {
+                        best = child;
+                    }
+                }
+                if (entries[best] >= last) {
+                    break;
+                }
+                entries[i] = entries[best];
+                i = best;
+            }
+            entries[i] = last;
+        }
+        return unpack(top);
+    }
+};
+
+using QuaternaryOpenList = DaryOpenList<4>;
+using OctonaryOpenList = DaryOpenList<8>;
+
+// Pairing heap in an index-linked pool: O(1) push and amortized
+// O(log n) pop with the two-pass merge. The pool is reused across queries.
+class PairingOpenList {
+private:
+    struct Entry {
+        float key;
+        int node;
+        int child;
+        int sibling;
+    };
+
+    std::vector<Entry> pool;
+    std::vector<int> siblings;
+    int root = -1;
+
+    bool less(int a, int b) const {
+        return pool[a].key < pool[b].key || (pool[a].key == pool[b].key && pool[a].node < pool[b].node);
+    }
+
+    int meld(int a, int b) {
+        if (a == -1) {
+            return b;
+        }
+        if (b == -1) {
+            return a;
+        }
+        if (less(b, a)) {
+            std::swap(a, b);
+        }
+        pool[b].sibling = pool[a].child;
+        pool[a].child = b;
+        return a;
+    }
+
+public:
+    void clear() {
+        pool.clear();
+        root = -1;
+    }
+
+    bool empty() const {
+        return root == -1;
+    }
+
+    void push(float key, int node) {
+        pool.push_back({key, node, -1, -1});
+        root = meld(root, static_cast<int>(pool.size()) - 1);
+    }
+
+    std::pair<float, int> pop() {
+        std::pair<float, int> top(pool[root].key, pool[root].node);
+        siblings.clear();
+        for (int child = pool[root].child; child != -1;) {
+            int next = pool[child].sibling;
+            pool[child].sibling = -1;
+            siblings.push_back(child);
+            child = next;
+        }
+        // First pass pairs neighbours left to right, second pass melds the
+        // pairs right to left.
+        std::size_t pairs = 0;
+        for (std::size_t i = 0; i < siblings.size(); i += 2) {
+            siblings[pairs++] = i + 1 < siblings.size() ? meld(siblings[i], siblings[i + 1]) : siblings[i];
+        }
+        int merged = -1;
+        while (pairs > 0) {
+            merged = meld(siblings[--pairs], merged);
+        }
+        root = merged;
+        return top;
+    }
+};
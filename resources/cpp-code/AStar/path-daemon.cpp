@@ -0,0 +1,694 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+
+#include "grid-graph.hpp"
+#include "map-io.hpp"
+#include "path-protocol.hpp"
+#include "search-core.hpp"
+#include "shm-channel.hpp"
+
+struct PendingQuery {
+    std::uint64_t connection;
+    PathQuery query;
+};
+
+struct Completion {
+    std::uint64_t connection;
+    std::string bytes;
+    std::uint32_t replies = 0;
+};
+
+// Worker threads that solve coalesced batches. Every worker takes queries
+// from the oldest batch one at a time, so a burst is spread over the whole
+// pool; the worker that finishes a batch's last query groups its replies
+// per connection, in batch order, and hands them back to the event loop
+// through an eventfd. Each worker keeps one SearchCore per map, so scratch
+// arrays are reused across batches.
+class SearchPool {
+private:
+    struct Batch {
+        std::vector<PendingQuery> queries;
+        std::vector<std::string> replies;    // serialized, one per query
+        std::size_t next = 0;                // first unclaimed query; under batch_mutex
+        std::atomic<std::size_t> solved{0};
+    };
+
+    const std::vector<std::unique_ptr<GridGraph>>& maps;
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<Batch>> batches;
+    std::mutex batch_mutex;
+    std::condition_variable batch_ready;
+    bool stopping;
+
+    std::vector<Completion> completions;
+    std::mutex completion_mutex;
+    int notify_fd;
+
+    static PathReplyHeader solve(SearchCore<GridGraph>* search, const GridGraph* graph, const PathQuery& query,
+                                 std::vector<PathCell>& cells) {
+        PathReplyHeader header{query.request_id, PATH_NOT_FOUND, 0.0f, 0};
+        cells.clear();
+        if (search == nullptr) {
+            header.status = PATH_BAD_MAP;
+            return header;
+        }
+        auto inside = [&](int r, int c) {
+            return r >= 0 && r < graph->row_count() && c >= 0 && c < graph->column_count() &&
+                   graph->passable(graph->node(r, c));
+        };
+        if (!inside(query.start_row, query.start_col) || !inside(query.goal_row, query.goal_col)) {
+            header.status = PATH_BAD_CELL;
+            return header;
+        }
+        SearchResult result = search->execute(graph->node(query.start_row, query.start_col),
+                                              graph->node(query.goal_row, query.goal_col));
+        if (result.found) {
+            header.status = PATH_FOUND;
+            header.cost = result.cost;
+            cells.reserve(result.path.size());
+            for (int node : result.path) {
+                auto p = graph->coordinates(node);
+                cells.push_back({p.first, p.second});
+            }
+            header.length = static_cast<std::uint32_t>(cells.size());
+        }
+        return header;
+    }
+
+    void finish(Batch& batch) {
+        std::unordered_map<std::uint64_t, std::size_t> slot_of;
+        std::vector<Completion> grouped;
+        for (std::size_t i = 0; i < batch.queries.size(); i++) {
+            std::uint64_t connection = batch.queries[i].connection;
+            auto slot = slot_of.emplace(connection, grouped.size());
+            if (slot.second) {
+                grouped.push_back({connection, std::string()});
+            }
+            Completion& reply = grouped[slot.first->second];
+            reply.replies++;
+            reply.bytes += batch.replies[i];
+        }
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex);
+            for (auto& reply : grouped) {
+                completions.push_back(std::move(reply));
+            }
+        }
+        std::uint64_t one = 1;
+        ssize_t ignored = write(notify_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    void work() {
+        std::vector<std::unique_ptr<SearchCore<GridGraph>>> searches(maps.size());
+        std::vector<PathCell> cells;
+        while (true) {
+            std::shared_ptr<Batch> batch;
+            std::size_t index;
+            {
+                std::unique_lock<std::mutex> lock(batch_mutex);
+                batch_ready.wait(lock, [&]() { return stopping || !batches.empty(); });
+                if (batches.empty()) {
+                    return;
+                }
+                batch = batches.front();
+                index = batch->next++;
+                if (batch->next == batch->queries.size()) {
+                    batches.pop_front();
+                }
+            }
+
+            const PathQuery& query = batch->queries[index].query;
+            SearchCore<GridGraph>* search = nullptr;
+            const GridGraph* graph = nullptr;
+            if (query.map_id < maps.size()) {
+                auto& slot = searches[query.map_id];
+                if (!slot) {
+                    slot = std::make_unique<SearchCore<GridGraph>>(*maps[query.map_id]);
+                }
+                search = slot.get();
+                graph = maps[query.map_id].get();
+            }
+            PathReplyHeader header = solve(search, graph, query, cells);
+            append_reply(batch->replies[index], header, cells);
+            if (batch->solved.fetch_add(1, std::memory_order_acq_rel) + 1 == batch->queries.size()) {
+                finish(*batch);
+            }
+        }
+    }
+
+public:
+    SearchPool(const std::vector<std::unique_ptr<GridGraph>>& maps_, int threads, int notify_fd_)
+        : maps(maps_), stopping(false), notify_fd(notify_fd_) {
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~SearchPool() {
+        {
+            std::lock_guard<std::mutex> lock(batch_mutex);
+            stopping = true;
+        }
+        batch_ready.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void submit(std::vector<PendingQuery> queries) {
+        if (queries.empty()) {
+            return;
+        }
+        auto batch = std::make_shared<Batch>();
+        batch->replies.resize(queries.size());
+        batch->queries = std::move(queries);
+        {
+            std::lock_guard<std::mutex> lock(batch_mutex);
+            batches.push_back(std::move(batch));
+        }
+        batch_ready.notify_all();
+    }
+
+    std::vector<Completion> take_completions() {
+        std::lock_guard<std::mutex> lock(completion_mutex);
+        std::vector<Completion> taken;
+        taken.swap(completions);
+        return taken;
+    }
+};
+
+// Serves one shared-memory channel from a dedicated thread: queries are
+// popped from the ring, paths are written by SearchCore::write_path()
+// straight into the shared arena, and results carry only their position.
+class ShmPathServer {
+private:
+    const std::vector<std::unique_ptr<GridGraph>>& maps;
+    ShmMapping mapping;
+    std::atomic<bool> stopping;
+    std::thread worker;
+
+    void serve() {
+        ShmChannel& channel = mapping.get();
+        std::vector<std::unique_ptr<SearchCore<GridGraph>>> searches(maps.size());
+        ShmQuery query;
+        while (channel.queries.pop(query, &stopping)) {
+            ShmResult result{query.request_id, PATH_NOT_FOUND, 0.0f, 0, 0};
+            const GridGraph* graph = query.map_id < maps.size() ? maps[query.map_id].get() : nullptr;
+            auto inside = [&](int r, int c) {
+                return r >= 0 && r < graph->row_count() && c >= 0 && c < graph->column_count() &&
+                       graph->passable(graph->node(r, c));
+            };
+            if (graph == nullptr) {
+                result.status = PATH_BAD_MAP;
+            } else if (!inside(query.start_row, query.start_col) || !inside(query.goal_row, query.goal_col)) {
+                result.status = PATH_BAD_CELL;
+            } else {
+                auto& search = searches[query.map_id];
+                if (!search) {
+                    search = std::make_unique<SearchCore<GridGraph>>(*graph);
+                }
+                int target = graph->node(query.goal_row, query.goal_col);
+                SearchResult found = search->solve(graph->node(query.start_row, query.start_col), target);
+                if (found.found) {
+                    std::uint32_t length = static_cast<std::uint32_t>(search->path_length(target));
+                    result.cost = found.cost;
+                    if (length > channel.arena.capacity()) {
+                        result.status = PATH_TOO_LONG;
+                    } else if (channel.arena.allocate(length, result.path_position, &stopping)) {
+                        search->write_path(target, channel.arena.at(result.path_position), [&](int node) {
+                            auto p = graph->coordinates(node);
+                            return PathCell{p.first, p.second};
+                        });
+                        result.status = PATH_FOUND;
+                        result.length = length;
+                    } else {
+                        return;
+                    }
+                }
+            }
+            if (!channel.results.push(result, &stopping)) {
+                return;
+            }
+        }
+    }
+
+public:
+    ShmPathServer(const std::string& name, const std::vector<std::unique_ptr<GridGraph>>& maps_)
+        : maps(maps_), mapping(name, true), stopping(false) {
+        worker = std::thread([this]() { serve(); });
+    }
+
+    ~ShmPathServer() {
+        stopping = true;
+        worker.join();
+    }
+};
+
+struct DaemonOptions {
+    std::string socket_path;
+    std::vector<std::string> map_paths;
+    std::vector<std::string> shm_channels;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int window_us = 200;
+    int max_batch = 256;
+    std::size_t max_buffered = 4 << 20;   // unsent reply bytes per client
+    std::uint32_t max_outstanding = 4096; // unanswered queries per client
+};
+
+// Single-threaded epoll loop: accepts clients, parses queries, coalesces
+// those arriving within window_us (or until max_batch) into one batch for
+// the pool, and writes replies back as the pool completes them. A client
+// is not read from while it has max_buffered reply bytes unsent or
+// max_outstanding queries unanswered, so a slow reader cannot grow the
+// daemon without limit. A client that shuts down its write side still gets
+// every reply before the connection is closed.
+class PathDaemon {
+private:
+    struct Connection {
+        int fd;
+        std::string in;
+        std::string out;
+        std::uint32_t events;       // what epoll watches for
+        std::uint32_t outstanding;  // queries enqueued but not yet answered
+        bool peer_closed;           // read() returned 0
+    };
+
+    const DaemonOptions& options;
+    std::vector<std::unique_ptr<GridGraph>> maps;
+    int epoll_fd;
+    int listen_fd;
+    int notify_fd;
+    int timer_fd;
+    int signal_fd;
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::unordered_map<int, std::uint64_t> connection_by_fd;
+    std::uint64_t next_connection;
+    std::vector<PendingQuery> pending;
+    bool timer_armed;
+    std::unique_ptr<SearchPool> pool;
+    std::vector<std::unique_ptr<ShmPathServer>> shm_servers;
+
+    void watch(int fd, std::uint32_t events) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void rewatch(int fd, std::uint32_t events) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    }
+
+    void flush_batch() {
+        if (timer_armed) {
+            itimerspec off;
+            std::memset(&off, 0, sizeof(off));
+            timerfd_settime(timer_fd, 0, &off, nullptr);
+            timer_armed = false;
+        }
+        if (!pending.empty()) {
+            std::vector<PendingQuery> batch;
+            batch.swap(pending);
+            pool->submit(std::move(batch));
+        }
+    }
+
+    void enqueue(std::uint64_t connection, const PathQuery& query) {
+        connections[connection].outstanding++;
+        pending.push_back({connection, query});
+        if (static_cast<int>(pending.size()) >= options.max_batch || options.window_us <= 0) {
+            flush_batch();
+        } else if (!timer_armed) {
+            itimerspec window;
+            std::memset(&window, 0, sizeof(window));
+            window.it_value.tv_sec = options.window_us / 1000000;
+            window.it_value.tv_nsec = static_cast<long>(options.window_us % 1000000) * 1000;
+            timerfd_settime(timer_fd, 0, &window, nullptr);
+            timer_armed = true;
+        }
+    }
+
+    void close_connection(std::uint64_t id) {
+        auto it = connections.find(id);
+        if (it == connections.end()) {
+            return;
+        }
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+        connection_by_fd.erase(it->second.fd);
+        connections.erase(it);
+    }
+
+    void accept_clients() {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            std::uint64_t id = next_connection++;
+            connections[id] = Connection{fd, std::string(), std::string(), EPOLLIN | EPOLLRDHUP, 0, false};
+            connection_by_fd[fd] = id;
+            watch(fd, EPOLLIN | EPOLLRDHUP);
+        }
+    }
+
+    bool accepting(const Connection& connection) const {
+        return !connection.peer_closed && connection.out.size() < options.max_buffered &&
+               connection.outstanding < options.max_outstanding;
+    }
+
+    // Watches for input only while the client is under its limits and for
+    // output only while replies are waiting; closes the connection once a
+    // client that finished sending has been answered in full.
+    void update_interest(std::uint64_t id) {
+        Connection& connection = connections.at(id);
+        if (connection.peer_closed && connection.outstanding == 0 && connection.out.empty()) {
+            close_connection(id);
+            return;
+        }
+        std::uint32_t events = (accepting(connection) ? static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP) : 0u) |
+                               (connection.out.empty() ? 0u : static_cast<std::uint32_t>(EPOLLOUT));
+        if (events != connection.events) {
+            connection.events = events;
+            rewatch(connection.fd, events);
+        }
+    }
+
+    void read_client(std::uint64_t id) {
+        auto it = connections.find(id);
+        if (it == connections.end()) {
+            return;
+        }
+        Connection& connection = it->second;
+        char buffer[64 * 1024];
+        // Complete records are enqueued after every read, so `in` never holds
+        // more than one buffer plus a partial record.
+        while (accepting(connection)) {
+            ssize_t got = read(connection.fd, buffer, sizeof(buffer));
+            if (got < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                close_connection(id);
+                return;
+            }
+            if (got == 0) {
+                // A trailing partial record can never complete.
+                connection.peer_closed = true;
+                connection.in.clear();
+                break;
+            }
+            connection.in.append(buffer, static_cast<size_t>(got));
+            size_t offset = 0;
+            while (connection.in.size() - offset >= sizeof(PathQuery)) {
+                PathQuery query;
+                std::memcpy(&query, connection.in.data() + offset, sizeof(query));
+                offset += sizeof(query);
+                enqueue(id, query);
+            }
+            connection.in.erase(0, offset);
+        }
+        update_interest(id);
+    }
+
+    void write_client(std::uint64_t id) {
+        auto it = connections.find(id);
+        if (it == connections.end()) {
+            return;
+        }
+        Connection& connection = it->second;
+        size_t offset = 0;
+        while (offset < connection.out.size()) {
+            // MSG_NOSIGNAL: a client that closed early gives EPIPE (or
+            // ECONNRESET) here instead of a SIGPIPE that kills the daemon.
+            ssize_t written = send(connection.fd, connection.out.data() + offset, connection.out.size() - offset,
+                                   MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                close_connection(id);
+                return;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        connection.out.erase(0, offset);
+        update_interest(id);
+    }
+
+    void deliver_completions() {
+        std::uint64_t count;
+        ssize_t ignored = read(notify_fd, &count, sizeof(count));
+        (void)ignored;
+        for (auto& completion : pool->take_completions()) {
+            auto it = connections.find(completion.connection);
+            if (it == connections.end()) {
+                continue;
+            }
+            it->second.outstanding -= completion.replies;
+            it->second.out += completion.bytes;
+            write_client(completion.connection);
+        }
+    }
+
+public:
+    explicit PathDaemon(const DaemonOptions& options_)
+        : options(options_), next_connection(1), timer_armed(false) {
+        for (const auto& path : options.map_paths) {
+            maps.push_back(std::make_unique<GridGraph>(load_grid_text(path)));
+        }
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        sigprocmask(SIG_BLOCK, &signals, nullptr);
+        signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        sockaddr_un address = unix_address(options.socket_path);
+        unlink(options.socket_path.c_str());
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listen_fd, 128) != 0) {
+            throw std::runtime_error("cannot listen on " + options.socket_path + ": " + std::strerror(errno));
+        }
+
+        watch(listen_fd, EPOLLIN);
+        watch(notify_fd, EPOLLIN);
+        watch(timer_fd, EPOLLIN);
+        watch(signal_fd, EPOLLIN);
+        pool = std::make_unique<SearchPool>(maps, options.threads, notify_fd);
+        for (const auto& name : options.shm_channels) {
+            shm_servers.push_back(std::make_unique<ShmPathServer>(name, maps));
+        }
+    }
+
+    ~PathDaemon() {
+        shm_servers.clear();
+        pool.reset();
+        while (!connections.empty()) {
+            close_connection(connections.begin()->first);
+        }
+        close(listen_fd);
+        unlink(options.socket_path.c_str());
+        close(signal_fd);
+        close(timer_fd);
+        close(notify_fd);
+        close(epoll_fd);
+    }
+
+    void run() {
+        std::vector<epoll_event> events(256);
+        while (true) {
+            int ready = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                if (fd == signal_fd) {
+                    return;
+                }
+                if (fd == listen_fd) {
+                    accept_clients();
+                } else if (fd == notify_fd) {
+                    deliver_completions();
+                } else if (fd == timer_fd) {
+                    std::uint64_t expirations;
+                    ssize_t ignored = read(timer_fd, &expirations, sizeof(expirations));
+                    (void)ignored;
+                    timer_armed = false;
+                    flush_batch();
+                } else {
+                    auto it = connection_by_fd.find(fd);
+                    if (it == connection_by_fd.end()) {
+                        continue;
+                    }
+                    std::uint64_t id = it->second;
+                    // HUP means both directions are shut: replies can no longer
+                    // be delivered.
+                    if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                        close_connection(id);
+                        continue;
+                    }
+                    if (events[i].events & EPOLLOUT) {
+                        write_client(id);
+                    }
+                    if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                        read_client(id);
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Sends every (start, goal) quadruple in one go, then prints the replies
+// as they come back.
+int run_client(const std::string& socket_path, std::uint32_t map_id, const std::vector<int>& cells) {
+    int fd = connect_path_daemon(socket_path);
+    std::vector<PathQuery> queries;
+    for (size_t i = 0; i + 3 < cells.size(); i += 4) {
+        queries.push_back({static_cast<std::uint32_t>(queries.size()), map_id,
+                           cells[i], cells[i + 1], cells[i + 2], cells[i + 3]});
+    }
+    write_all(fd, queries.data(), queries.size() * sizeof(PathQuery));
+    for (size_t i = 0; i < queries.size(); i++) {
+        auto reply = read_reply(fd);
+        std::cout << "Query " << reply.first.request_id << ":";
+        if (reply.first.status != PATH_FOUND) {
+            std::cout << " status " << reply.first.status << std::endl;
+            continue;
+        }
+        for (const auto& cell : reply.second) {
+            std::cout << " (" << cell.row << "," << cell.col << ")";
+        }
+        std::cout << " cost " << reply.first.cost << std::endl;
+    }
+    close(fd);
+    return 0;
+}
+
+// Same as run_client() but through a shared-memory channel; paths are
+// printed straight from the arena.
+int run_shm_client(const std::string& name, std::uint32_t map_id, const std::vector<int>& cells) {
+    ShmPathClient client(name);
+    std::uint32_t count = 0;
+    for (size_t i = 0; i + 3 < cells.size(); i += 4) {
+        client.submit({count++, map_id, cells[i], cells[i + 1], cells[i + 2], cells[i + 3]});
+    }
+    for (std::uint32_t i = 0; i < count; i++) {
+        ShmResult result = client.receive();
+        std::cout << "Query " << result.request_id << ":";
+        if (result.status != PATH_FOUND) {
+            std::cout << " status " << result.status << std::endl;
+            continue;
+        }
+        const PathCell* path = client.path(result);
+        for (std::uint32_t j = 0; j < result.length; j++) {
+            std::cout << " (" << path[j].row << "," << path[j].col << ")";
+        }
+        std::cout << " cost " << result.cost << std::endl;
+        client.release(result);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Writes to a peer that went away fail with EPIPE instead of killing
+    // the process, in the daemon and in the clients.
+    std::signal(SIGPIPE, SIG_IGN);
+    if (argc >= 4 && (std::string(argv[1]) == "--query" || std::string(argv[1]) == "--shm-query")) {
+        std::vector<int> cells;
+        for (int i = 4; i < argc; i++) {
+            cells.push_back(std::atoi(argv[i]));
+        }
+        auto map_id = static_cast<std::uint32_t>(std::atoi(argv[3]));
+        try {
+            if (std::string(argv[1]) == "--shm-query") {
+                return run_shm_client(argv[2], map_id, cells);
+            }
+            return run_client(argv[2], map_id, cells);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    DaemonOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--window-us" && i + 1 < argc) {
+            options.window_us = std::atoi(argv[++i]);
+        } else if (arg == "--max-batch" && i + 1 < argc) {
+            options.max_batch = std::atoi(argv[++i]);
+        } else if (arg == "--max-buffered" && i + 1 < argc) {
+            options.max_buffered = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--max-outstanding" && i + 1 < argc) {
+            options.max_outstanding = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        } else if (arg == "--shm" && i + 1 < argc) {
+            options.shm_channels.push_back(argv[++i]);
+        } else if (options.socket_path.empty()) {
+            options.socket_path = arg;
+        } else {
+            options.map_paths.push_back(arg);
+        }
+    }
+    if (options.socket_path.empty() || options.map_paths.empty() || options.threads < 1) {
+        std::cerr << "usage: path-daemon <socket> <map>... [--threads N] [--window-us N] [--max-batch N]"
+                  << " [--max-buffered BYTES] [--max-outstanding N] [--shm /name]..." << std::endl;
+        std::cerr << "       path-daemon --query <socket> <map_id> <sr> <sc> <gr> <gc> [...]" << std::endl;
+        std::cerr << "       path-daemon --shm-query /name <map_id> <sr> <sc> <gr> <gc> [...]" << std::endl;
+        return 1;
+    }
+
+    try {
+        PathDaemon daemon(options);
+        std::cout << "Serving " << options.map_paths.size() << " map(s) on " << options.socket_path << std::endl;
+        daemon.run();
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
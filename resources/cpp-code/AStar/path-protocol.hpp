@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Binary protocol of path-daemon. Messages are fixed-layout structs in host
+// byte order (client and daemon share a host). A client may pipeline any
+// number of queries; each gets exactly one reply carrying its request_id,
+// and replies can arrive in any order.
+struct PathQuery {
+    std::uint32_t request_id;
+    std::uint32_t map_id;
+    std::int32_t start_row;
+    std::int32_t start_col;
+    std::int32_t goal_row;
+    std::int32_t goal_col;
+};
+static_assert(sizeof(PathQuery) == 24, "PathQuery must stay packed");
+
+enum PathStatus : std::uint32_t {
+    PATH_FOUND = 0,
+    PATH_NOT_FOUND = 1,
+    PATH_BAD_MAP = 2,
+    PATH_BAD_CELL = 3,
+    PATH_TOO_LONG = 4
+};
+
+// Followed by `length` PathCell entries from start to goal.
+struct PathReplyHeader {
+    std::uint32_t request_id;
+    std::uint32_t status;
+    float cost;
+    std::uint32_t length;
+};
+static_assert(sizeof(PathReplyHeader) == 16, "PathReplyHeader must stay packed");
+
+struct PathCell {
+    std::int32_t row;
+    std::int32_t col;
+};
+static_assert(sizeof(PathCell) == 8, "PathCell must stay packed");
+
+inline void append_reply(std::string& out, const PathReplyHeader& header, const std::vector<PathCell>& cells) {
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!cells.empty()) {
+        out.append(reinterpret_cast<const char*>(cells.data()), cells.size() * sizeof(PathCell));
+    }
+}
+
+inline sockaddr_un unix_address(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+// Blocking client helpers.
+inline int connect_path_daemon(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("socket() failed");
+    }
+    sockaddr_un address = unix_address(path);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot connect to " + path);
+    }
+    return fd;
+}
+
+inline void write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0) {
+            throw std::runtime_error("write to path daemon failed");
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+inline void read_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got <= 0) {
+            throw std::runtime_error("path daemon closed the connection");
+        }
+        bytes += got;
+        size -= static_cast<size_t>(got);
+    }
+}
+
+inline std::pair<PathReplyHeader, std::vector<PathCell>> read_reply(int fd) {
+    PathReplyHeader header;
+    read_all(fd, &header, sizeof(header));
+    std::vector<PathCell> cells(header.length);
+    if (header.length > 0) {
+        read_all(fd, cells.data(), cells.size() * sizeof(PathCell));
+    }
+    return std::make_pair(header, std::move(cells));
+}
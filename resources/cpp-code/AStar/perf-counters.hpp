@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Counters read together as one perf_event_open group, so every value in
+// a sample covers exactly the same instructions. Only user-space events of
+// this thread are counted.
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_TASK_CLOCK,   // nanoseconds, a software event that works without a PMU
+    PERF_COUNTER_COUNT
+};
+
+struct PerfSample {
+    std::uint64_t value[PERF_COUNTER_COUNT] = {};
+
+    PerfSample& operator+=(const PerfSample& other) {
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            value[i] += other.value[i];
+        }
+        return *this;
+    }
+};
+
+inline PerfSample operator-(const PerfSample& a, const PerfSample& b) {
+    PerfSample d;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        d.value[i] = a.value[i] - b.value[i];
+    }
+    return d;
+}
+
+// The group of PerfCounter events for the calling thread. Counters the
+// kernel or the machine refuses (no PMU in a VM, perf_event_paranoid, not
+// Linux) are left out and read as zero; available() tells which ones are
+// real. The group is never multiplexed with other work of this process,
+// but may be by the kernel if other users hold the PMU.
+class PerfCounterGroup {
+private:
+    int leader = -1;
+    int fds[PERF_COUNTER_COUNT];
+    int slot[PERF_COUNTER_COUNT];   // position in the group read, -1 if absent
+    int opened = 0;
+
+#if defined(__linux__)
+    static int open_event(std::uint32_t type, std::uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+public:
+    PerfCounterGroup() {
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            fds[i] = -1;
+            slot[i] = -1;
+        }
+#if defined(__linux__)
+        const std::uint32_t types[PERF_COUNTER_COUNT] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE};
+        const std::uint64_t configs[PERF_COUNTER_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_TASK_CLOCK};
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            int fd = open_event(types[i], configs[i], leader);
+            if (fd < 0) {
+                continue;
+            }
+            if (leader == -1) {
+                leader = fd;
+            }
+            fds[i] = fd;
+            slot[i] = opened++;
+        }
+        if (leader != -1) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    ~PerfCounterGroup() {
+#if defined(__linux__)
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (fds[i] != -1) {
+                close(fds[i]);
+            }
+        }
+#endif
+    }
+
+    bool available(int counter) const {
+        return slot[counter] != -1;
+    }
+
+    // One read() of the whole group.
+    PerfSample read() const {
+        PerfSample sample;
+#if defined(__linux__)
+        if (leader == -1) {
+            return sample;
+        }
+        std::uint64_t buffer[1 + PERF_COUNTER_COUNT];
+        if (::read(leader, buffer, sizeof(buffer)) < static_cast<ssize_t>(sizeof(std::uint64_t))) {
+            return sample;
+        }
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (slot[i] != -1 && static_cast<std::uint64_t>(slot[i]) < buffer[0]) {
+                sample.value[i] = buffer[1 + slot[i]];
+            }
+        }
+#endif
+        return sample;
+    }
+};
+
+// Scoped phases of one SearchCore expansion. The closed-set check is the
+// one on the popped node; the check on each neighbor is part of RELAX,
+// which runs inside NEIGHBORS (edge generation) and is split out of it.
+enum SearchPhase {
+    PHASE_POP,
+    PHASE_CLOSED_CHECK,
+    PHASE_NEIGHBORS,
+    PHASE_RELAX,
+    PHASE_COUNT,
+    PHASE_NONE = PHASE_COUNT
+};
+
+inline const char* phase_name(int phase) {
+    static const char* const names[PHASE_COUNT] = {"pop", "closed check", "neighbors", "relax"};
+    return names[phase];
+}
+
+// SearchCore's default probe: every call is empty and inlines away.
+struct NullProbe {
+    void begin() {}
+    void end() {}
+    void enter(SearchPhase) {}
+};
+
+struct PerfTotals {
+    PerfSample phase[PHASE_COUNT];
+    PerfSample search;                 // whole solve() calls
+    std::size_t searches = 0;
+    std::size_t sampled_pops = 0;
+    bool available[PERF_COUNTER_COUNT] = {};
+
+    PerfTotals& operator+=(const PerfTotals& other) {
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            phase[p] += other.phase[p];
+        }
+        search += other.search;
+        searches += other.searches;
+        sampled_pops += other.sampled_pops;
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            available[i] = available[i] || other.available[i];
+        }
+        return *this;
+    }
+};
+
+// SearchCore probe that charges the counter group to the phase being run.
+// Every phase switch costs one read() system call, so phases are only
+// timed on one pop in sample_period; whole searches are always
+// counted. Counts include the probe's own user-space overhead, which
+// grows with the sampling rate.
+class PerfPhaseProbe {
+private:
+    PerfCounterGroup counters;
+    PerfTotals sums;
+    PerfSample search_start;
+    PerfSample phase_start;
+    int current = PHASE_NONE;
+    std::uint32_t period = 1;
+    std::uint32_t countdown = 1;
+    bool sampling = false;
+
+public:
+    PerfPhaseProbe() {
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            sums.available[i] = counters.available(i);
+        }
+    }
+
+    void set_sample_period(std::uint32_t period_) {
+        period = period_ > 0 ? period_ : 1;
+        countdown = 1;
+    }
+
+    void begin() {
+        current = PHASE_NONE;
+        search_start = counters.read();
+    }
+
+    void end() {
+        enter(PHASE_NONE);
+        sums.search += counters.read() - search_start;
+        sums.searches++;
+    }
+
+    void enter(SearchPhase phase) {
+        if (phase == PHASE_POP) {
+            sampling = --countdown == 0;
+            if (sampling) {
+                countdown = period;
+                sums.sampled_pops++;
+            }
+        }
+        if (!sampling && current == PHASE_NONE) {
+            return;
+        }
+        PerfSample now = counters.read();
+        if (current != PHASE_NONE) {
+            sums.phase[current] += now - phase_start;
+        }
+        current = sampling ? phase : PHASE_NONE;
+        phase_start = now;
+    }
+
+    const PerfTotals& totals() const {
+        return sums;
+    }
+
+    void reset() {
+        bool available[PERF_COUNTER_COUNT];
+        std::memcpy(available, sums.available, sizeof(available));
+        sums = PerfTotals();
+        std::memcpy(sums.available, available, sizeof(available));
+    }
+};
@@ -0,0 +1,465 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "grid-graph.hpp"
+#include "search-core.hpp"
+
+// FIFO of at most `capacity` items between two pipeline stages. push()
+// blocks while it is full, pop() while it is empty; after close(), push()
+// refuses new items and pop() drains what is left, then returns false.
+template <class T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    std::size_t capacity;
+    bool closed;
+    std::mutex lock;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+
+public:
+    explicit BoundedQueue(std::size_t capacity_) : capacity(std::max<std::size_t>(1, capacity_)), closed(false) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> guard(lock);
+        not_full.wait(guard, [&]() { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> guard(lock);
+        not_empty.wait(guard, [&]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+};
+
+// Admits sequence numbers less than `window` ahead of the oldest one not
+// yet retired. enter() blocks until its number fits; after close() it
+// returns false at once.
+class SequenceWindow {
+private:
+    std::size_t window;
+    std::size_t retired;
+    bool closed;
+    std::mutex lock;
+    std::condition_variable moved;
+
+public:
+    explicit SequenceWindow(std::size_t window_) : window(std::max<std::size_t>(1, window_)), retired(0), closed(false) {}
+
+    bool enter(std::size_t sequence) {
+        std::unique_lock<std::mutex> guard(lock);
+        moved.wait(guard, [&]() { return closed || sequence < retired + window; });
+        return !closed;
+    }
+
+    void retire() {
+        std::lock_guard<std::mutex> guard(lock);
+        retired++;
+        moved.notify_all();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        moved.notify_all();
+    }
+};
+
+struct StreamQuery {
+    int start_row;
+    int start_col;
+    int goal_row;
+    int goal_col;
+};
+
+enum class StreamStatus : std::uint8_t { FOUND, NOT_FOUND, BAD_CELL };
+
+struct StreamOptions {
+    int threads = 0;                          // solver threads, 0 = all CPUs
+    std::size_t batch_size = 4096;            // queries per batch between stages
+    std::size_t queue_batches = 0;            // per queue, 0 = 2 * threads
+    std::size_t block_bytes = 1 << 20;        // read and write size
+    bool paths = false;                       // append each path's cells
+};
+
+struct StreamStats {
+    std::size_t queries = 0;
+    std::size_t found = 0;
+    std::size_t bad = 0;
+};
+
+// Streams queries from in_fd to out_fd through three stages:
+//
+//     parser --(query batches)--> solvers --(result batches)--> writer
+//
+// Input is whitespace-separated integers, four per query (start row, start
+// column, goal row, goal column), read in block_bytes chunks; line breaks
+// carry no meaning. Each query yields one line, in input order:
+//
+//     <index> found <cost> <length> [<row>,<col> ...]
+//     <index> none
+//     <index> bad
+//
+// "bad" marks endpoints outside the map or on walls. The parser runs on
+// its own thread, solvers each keep one SearchCore, and the writer runs on
+// the calling thread, restoring input order and flushing block_bytes at a
+// time. The parser stays at most 2 * queue_batches + threads batches ahead
+// of the writer, so results held back behind one slow batch are bounded
+// too. Malformed input or an I/O error throws std::runtime_error once the
+// stages have stopped.
+class QueryPipeline {
+private:
+    struct QueryBatch {
+        std::size_t sequence = 0;
+        std::vector<StreamQuery> queries;
+    };
+
+    struct ResultBatch {
+        std::size_t sequence = 0;
+        std::vector<StreamStatus> status;
+        std::vector<float> cost;
+        std::vector<std::uint32_t> length;     // cells on each path
+        std::vector<int> cells;                // row, col pairs of every path, with StreamOptions::paths
+    };
+
+    const GridGraph& grid;
+    StreamOptions options;
+    std::mutex error_lock;
+    std::exception_ptr error;
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> guard(error_lock);
+        if (!error) {
+            error = e;
+        }
+    }
+
+    void parse(int in_fd, BoundedQueue<QueryBatch>& queries, SequenceWindow& in_flight) {
+        std::vector<char> block(options.block_bytes);
+        QueryBatch batch;
+        std::size_t sequence = 0;
+        int fields[4];
+        int field = 0;
+        long value = 0;
+        bool negative = false;
+        bool in_number = false;
+        auto finish_number = [&]() {
+            fields[field++] = static_cast<int>(negative ? -value : value);
+            value = 0;
+            negative = false;
+            in_number = false;
+            if (field == 4) {
+                batch.queries.push_back({fields[0], fields[1], fields[2], fields[3]});
+                field = 0;
+            }
+        };
+        while (true) {
+            ssize_t got = ::read(in_fd, block.data(), block.size());
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("query stream: read failed: ") + std::strerror(errno));
+            }
+            if (got == 0) {
+                break;
+            }
+            for (ssize_t i = 0; i < got; i++) {
+                char ch = block[i];
+                if (ch >= '0' && ch <= '9') {
+                    value = value * 10 + (ch - '0');
+                    in_number = true;
+                    if (value > 1000000000L) {
+                        throw std::runtime_error("query stream: number out of range");
+                    }
+                } else if (ch == '-' && !in_number && !negative) {
+                    negative = true;
+                } else if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r') {
+                    if (in_number) {
+                        finish_number();
+                    } else if (negative) {
+                        throw std::runtime_error("query stream: stray '-'");
+                    }
+                } else {
+                    throw std::runtime_error(std::string("query stream: unexpected character '") + ch + "'");
+                }
+                if (batch.queries.size() == options.batch_size) {
+                    if (!in_flight.enter(batch.sequence) || !queries.push(std::move(batch))) {
+                        return;
+                    }
+                    batch = QueryBatch();
+                    batch.sequence = ++sequence;
+                }
+            }
+        }
+        if (in_number) {
+            finish_number();
+        }
+        if (field != 0 || negative) {
+            throw std::runtime_error("query stream: input ends inside a query");
+        }
+        if (!batch.queries.empty() && in_flight.enter(batch.sequence)) {
+            queries.push(std::move(batch));
+        }
+    }
+
+    void solve(BoundedQueue<QueryBatch>& queries, BoundedQueue<ResultBatch>& results) {
+        SearchCore<GridGraph> search(grid);
+        auto inside = [&](int r, int c) {
+            return r >= 0 && r < grid.row_count() && c >= 0 && c < grid.column_count() &&
+                   grid.passable(grid.node(r, c));
+        };
+        QueryBatch batch;
+        while (queries.pop(batch)) {
+            ResultBatch out;
+            out.sequence = batch.sequence;
+            out.status.reserve(batch.queries.size());
+            out.cost.reserve(batch.queries.size());
+            out.length.reserve(batch.queries.size());
+            for (const auto& q : batch.queries) {
+                StreamStatus status = StreamStatus::BAD_CELL;
+                float cost = 0.0f;
+                std::uint32_t length = 0;
+                if (inside(q.start_row, q.start_col) && inside(q.goal_row, q.goal_col)) {
+                    int target = grid.node(q.goal_row, q.goal_col);
+                    SearchResult result = search.solve(grid.node(q.start_row, q.start_col), target);
+                    status = result.found ? StreamStatus::FOUND : StreamStatus::NOT_FOUND;
+                    cost = result.cost;
+                    if (result.found) {
+                        length = static_cast<std::uint32_t>(search.path_length(target));
+                    }
+                    if (result.found && options.paths) {
+                        std::size_t first = out.cells.size();
+                        out.cells.resize(first + 2 * length);
+                        search.write_path(target, out.cells.data() + first, [&](int node) { return node; });
+                        // Expand node ids into row, col pairs in place, back to front.
+                        for (std::size_t i = length; i-- > 0;) {
+                            auto p = grid.coordinates(out.cells[first + i]);
+                            out.cells[first + 2 * i] = p.first;
+                            out.cells[first + 2 * i + 1] = p.second;
+                        }
+                    }
+                }
+                out.status.push_back(status);
+                out.cost.push_back(cost);
+                out.length.push_back(length);
+            }
+            if (!results.push(std::move(out))) {
+                return;
+            }
+        }
+    }
+
+    // Output buffer flushed to a file descriptor whenever it fills.
+    class BlockWriter {
+    private:
+        int fd;
+        std::vector<char> buffer;
+        std::size_t used;
+
+    public:
+        BlockWriter(int fd_, std::size_t size) : fd(fd_), buffer(std::max<std::size_t>(size, 256)), used(0) {}
+
+        void flush() {
+            std::size_t done = 0;
+            while (done < used) {
+                ssize_t wrote = ::write(fd, buffer.data() + done, used - done);
+                if (wrote < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error(std::string("query stream: write failed: ") + std::strerror(errno));
+                }
+                done += static_cast<std::size_t>(wrote);
+            }
+            used = 0;
+        }
+
+        // Room for at least `bytes` more characters.
+        char* reserve(std::size_t bytes) {
+            if (buffer.size() - used < bytes) {
+                flush();
+            }
+            return buffer.data() + used;
+        }
+
+        void commit(char* end) {
+            used = static_cast<std::size_t>(end - buffer.data());
+        }
+
+        void text(const char* s, std::size_t length) {
+            char* out = reserve(length);
+            std::memcpy(out, s, length);
+            commit(out + length);
+        }
+
+        template <class Number>
+        void number(Number value) {
+            char* out = reserve(32);
+            commit(std::to_chars(out, out + 32, value).ptr);
+        }
+
+        void character(char ch) {
+            char* out = reserve(1);
+            *out = ch;
+            commit(out + 1);
+        }
+    };
+
+    void write_batch(BlockWriter& writer, const ResultBatch& batch, std::size_t first_index, StreamStats& stats) {
+        std::size_t cell = 0;
+        for (std::size_t i = 0; i < batch.status.size(); i++) {
+            writer.number(first_index + i);
+            if (batch.status[i] == StreamStatus::FOUND) {
+                stats.found++;
+                writer.text(" found ", 7);
+                writer.number(batch.cost[i]);
+                writer.character(' ');
+                writer.number(batch.length[i]);
+                for (std::uint32_t k = 0; options.paths && k < batch.length[i]; k++, cell += 2) {
+                    writer.character(' ');
+                    writer.number(batch.cells[cell]);
+                    writer.character(',');
+                    writer.number(batch.cells[cell + 1]);
+                }
+            } else if (batch.status[i] == StreamStatus::NOT_FOUND) {
+                writer.text(" none", 5);
+            } else {
+                stats.bad++;
+                writer.text(" bad", 4);
+            }
+            writer.character('\n');
+        }
+        stats.queries += batch.status.size();
+    }
+
+public:
+    QueryPipeline(const GridGraph& grid_, StreamOptions options_) : grid(grid_), options(options_) {
+        if (options.threads <= 0) {
+            options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        if (options.queue_batches == 0) {
+            options.queue_batches = 2 * static_cast<std::size_t>(options.threads);
+        }
+        options.batch_size = std::max<std::size_t>(1, options.batch_size);
+        options.block_bytes = std::max<std::size_t>(4096, options.block_bytes);
+    }
+
+    StreamStats run(int in_fd, int out_fd) {
+        BoundedQueue<QueryBatch> queries(options.queue_batches);
+        BoundedQueue<ResultBatch> results(options.queue_batches);
+        SequenceWindow in_flight(2 * options.queue_batches + static_cast<std::size_t>(options.threads));
+        error = nullptr;
+
+        std::thread parser([&]() {
+            try {
+                parse(in_fd, queries, in_flight);
+            } catch (...) {
+                fail(std::current_exception());
+                results.close();
+            }
+            queries.close();
+        });
+        std::vector<std::thread> solvers;
+        std::mutex solvers_lock;
+        int solvers_left = options.threads;
+        for (int t = 0; t < options.threads; t++) {
+            solvers.emplace_back([&]() {
+                try {
+                    solve(queries, results);
+                } catch (...) {
+                    fail(std::current_exception());
+                    queries.close();
+                }
+                std::lock_guard<std::mutex> guard(solvers_lock);
+                if (--solvers_left == 0) {
+                    results.close();
+                }
+            });
+        }
+
+        StreamStats stats;
+        try {
+            BlockWriter writer(out_fd, options.block_bytes);
+            std::map<std::size_t, ResultBatch> early;
+            std::size_t expected = 0;
+            std::size_t first_index = 0;
+            ResultBatch batch;
+            while (results.pop(batch)) {
+                early.emplace(batch.sequence, std::move(batch));
+                for (auto next = early.find(expected); next != early.end(); next = early.find(expected)) {
+                    write_batch(writer, next->second, first_index, stats);
+                    first_index += next->second.status.size();
+                    early.erase(next);
+                    expected++;
+                    in_flight.retire();
+                }
+            }
+            writer.flush();
+        } catch (...) {
+            fail(std::current_exception());
+            queries.close();
+            results.close();
+        }
+        // A solver that failed leaves its batch unwritten forever.
+        in_flight.close();
+
+        parser.join();
+        for (auto& solver : solvers) {
+            solver.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return stats;
+    }
+};
+
+// Opens `path` for the pipeline, "-" meaning the given standard stream.
+inline int open_stream(const std::string& path, bool output) {
+    if (path == "-") {
+        return output ? STDOUT_FILENO : STDIN_FILENO;
+    }
+    int fd = output ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    return fd;
+}
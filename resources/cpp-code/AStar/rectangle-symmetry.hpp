@@ -0,0 +1,275 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#include "grid-graph.hpp"
+#include "search-core.hpp"
+
+// Rectangular symmetry reduction: passable cells split into rectangles of
+// one cost each, so a search can skip their interiors. Inside a uniform
+// rectangle every monotone path between two cells costs the same, so an
+// optimal path only needs a rectangle's perimeter cells plus one straight
+// jump across it; the cells in between are symmetric alternatives.
+//
+// Rectangles are grown greedily in row-major order from each unassigned
+// cell, keeping the larger of the right-then-down and down-then-right
+// growth. On rough terrain they are mostly 1x1 or thin, have no interior,
+// and searches behave exactly as on the GridGraph.
+class RectangleDecomposition {
+public:
+    struct Rectangle {
+        int top;
+        int left;
+        int bottom;   // inclusive
+        int right;    // inclusive
+        int cost;
+    };
+
+private:
+    const GridGraph& grid;
+    std::vector<int> rectangle_of;   // -1 for walls
+    std::vector<Rectangle> rectangles;
+    std::vector<std::uint8_t> plain;  // 1 where the cell's rectangle has no interior
+
+    bool free_cell(int r, int c, int cost) const {
+        int node = grid.node(r, c);
+        return rectangle_of[node] == -1 && grid.cost(node) == cost;
+    }
+
+    bool free_row(int r, int left, int right, int cost) const {
+        for (int c = left; c <= right; c++) {
+            if (!free_cell(r, c, cost)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool free_column(int c, int top, int bottom, int cost) const {
+        for (int r = top; r <= bottom; r++) {
+            if (!free_cell(r, c, cost)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit RectangleDecomposition(const GridGraph& grid_)
+        : grid(grid_), rectangle_of(grid_.node_count(), -1), plain(grid_.node_count(), 1) {
+        const int rows = grid.row_count();
+        const int cols = grid.column_count();
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int node = grid.node(r, c);
+                if (!grid.passable(node) || rectangle_of[node] != -1) {
+                    continue;
+                }
+                const int cost = grid.cost(node);
+                Rectangle wide{r, c, r, c, cost};
+                while (wide.right + 1 < cols && free_cell(r, wide.right + 1, cost)) {
+                    wide.right++;
+                }
+                while (wide.bottom + 1 < rows && free_row(wide.bottom + 1, c, wide.right, cost)) {
+                    wide.bottom++;
+                }
+                Rectangle tall{r, c, r, c, cost};
+                while (tall.bottom + 1 < rows && free_cell(tall.bottom + 1, c, cost)) {
+                    tall.bottom++;
+                }
+                while (tall.right + 1 < cols && free_column(tall.right + 1, r, tall.bottom, cost)) {
+                    tall.right++;
+                }
+                auto area = [](const Rectangle& box) {
+                    return static_cast<long>(box.bottom - box.top + 1) * (box.right - box.left + 1);
+                };
+                const Rectangle& box = area(tall) > area(wide) ? tall : wide;
+                int index = static_cast<int>(rectangles.size());
+                rectangles.push_back(box);
+                bool has_interior = box.bottom - box.top >= 2 && box.right - box.left >= 2;
+                for (int rr = box.top; rr <= box.bottom; rr++) {
+                    for (int cc = box.left; cc <= box.right; cc++) {
+                        rectangle_of[grid.node(rr, cc)] = index;
+                        plain[grid.node(rr, cc)] = has_interior ? 0 : 1;
+                    }
+                }
+            }
+        }
+    }
+
+    const GridGraph& graph() const {
+        return grid;
+    }
+
+    std::size_t rectangle_count() const {
+        return rectangles.size();
+    }
+
+    int rectangle_of_cell(int node) const {
+        return rectangle_of[node];
+    }
+
+    const Rectangle& rectangle(int index) const {
+        return rectangles[index];
+    }
+
+    // Whether the cell's rectangle is at most two cells thick, so every
+    // edge of the cell is a GridGraph edge.
+    bool plain_cell(int node) const {
+        return plain[node] != 0;
+    }
+
+    bool interior(int node) const {
+        const Rectangle& box = rectangles[rectangle_of[node]];
+        int r = node / grid.column_count();
+        int c = node % grid.column_count();
+        return r > box.top && r < box.bottom && c > box.left && c < box.right;
+    }
+
+    // Perimeter cells: the nodes a reduced search can still reach.
+    std::size_t perimeter_count() const {
+        std::size_t count = 0;
+        for (int node = 0; node < grid.node_count(); node++) {
+            count += rectangle_of[node] != -1 && !interior(node);
+        }
+        return count;
+    }
+};
+
+// GridGraph restricted to rectangle perimeters. A move that would enter a
+// rectangle's interior jumps straight to the far side instead, costing
+// the rectangle's cost per cell crossed; moves along a perimeter and into
+// other rectangles are the GridGraph's own. A start inside a rectangle
+// leaves it the same way, and when the target is inside one, every node
+// of that rectangle gets an edge straight to it, costing its cost times
+// the Manhattan distance. Path costs are the GridGraph's; paths skip the
+// crossed cells (see RectangleSearch). set_query() must be called before
+// each search.
+class RectangleGridGraph {
+private:
+    const RectangleDecomposition& decomposition;
+    const GridGraph& grid;
+    int rows;
+    int cols;
+    int target;
+    int target_rectangle;   // -1 unless the target is an interior cell
+
+public:
+    explicit RectangleGridGraph(const RectangleDecomposition& decomposition_)
+        : decomposition(decomposition_), grid(decomposition_.graph()),
+          rows(grid.row_count()), cols(grid.column_count()), target(-1), target_rectangle(-1) {}
+
+    void set_query(int initial, int target_) {
+        (void)initial;
+        target = target_;
+        target_rectangle = decomposition.interior(target) ? decomposition.rectangle_of_cell(target) : -1;
+    }
+
+    int node_count() const {
+        return grid.node_count();
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        if (decomposition.plain_cell(node)) {
+            grid.for_each_edge(node, visit);
+            return;
+        }
+        const int index = decomposition.rectangle_of_cell(node);
+        const RectangleDecomposition::Rectangle& box = decomposition.rectangle(index);
+        const float cost = static_cast<float>(box.cost);
+        const int r = node / cols;
+        const int c = node % cols;
+        const bool inner_column = c > box.left && c < box.right;
+        const bool inner_row = r > box.top && r < box.bottom;
+        if (r + 1 <= box.bottom) {
+            if (r + 1 < box.bottom && inner_column) {
+                visit(grid.node(box.bottom, c), cost * (box.bottom - r));
+            } else {
+                visit(node + cols, cost);
+            }
+        } else if (r + 1 < rows && grid.passable(node + cols)) {
+            visit(node + cols, static_cast<float>(grid.cost(node + cols)));
+        }
+        if (c + 1 <= box.right) {
+            if (c + 1 < box.right && inner_row) {
+                visit(grid.node(r, box.right), cost * (box.right - c));
+            } else {
+                visit(node + 1, cost);
+            }
+        } else if (c + 1 < cols && grid.passable(node + 1)) {
+            visit(node + 1, static_cast<float>(grid.cost(node + 1)));
+        }
+        if (r - 1 >= box.top) {
+            if (r - 1 > box.top && inner_column) {
+                visit(grid.node(box.top, c), cost * (r - box.top));
+            } else {
+                visit(node - cols, cost);
+            }
+        } else if (r > 0 && grid.passable(node - cols)) {
+            visit(node - cols, static_cast<float>(grid.cost(node - cols)));
+        }
+        if (c - 1 >= box.left) {
+            if (c - 1 > box.left && inner_row) {
+                visit(grid.node(r, box.left), cost * (c - box.left));
+            } else {
+                visit(node - 1, cost);
+            }
+        } else if (c > 0 && grid.passable(node - 1)) {
+            visit(node - 1, static_cast<float>(grid.cost(node - 1)));
+        }
+        if (index == target_rectangle && node != target) {
+            visit(target, cost * grid.heuristic(node, target));
+        }
+    }
+
+    float heuristic(int node, int target_) const {
+        return grid.heuristic(node, target_);
+    }
+};
+
+// SearchCore over a RectangleGridGraph that returns full cell paths: each
+// jump is filled in with the cells it crossed, rows first, all inside the
+// rectangle it crossed. expanded counts reduced nodes only.
+class RectangleSearch {
+private:
+    RectangleGridGraph graph;
+    SearchCore<RectangleGridGraph> core;
+    int cols;
+
+public:
+    explicit RectangleSearch(const RectangleDecomposition& decomposition)
+        : graph(decomposition), core(graph), cols(decomposition.graph().column_count()) {}
+
+    RectangleSearch(const RectangleSearch&) = delete;
+    RectangleSearch& operator=(const RectangleSearch&) = delete;
+
+    SearchResult execute(int initial, int target) {
+        graph.set_query(initial, target);
+        SearchResult result = core.execute(initial, target);
+        if (result.path.size() < 2) {
+            return result;
+        }
+        std::vector<int> cells = {result.path[0]};
+        for (std::size_t i = 1; i < result.path.size(); i++) {
+            int r = cells.back() / cols;
+            int c = cells.back() % cols;
+            const int to_r = result.path[i] / cols;
+            const int to_c = result.path[i] % cols;
+            while (r != to_r) {
+                r += r < to_r ? 1 : -1;
+                cells.push_back(r * cols + c);
+            }
+            while (c != to_c) {
+                c += c < to_c ? 1 : -1;
+                cells.push_back(r * cols + c);
+            }
+        }
+        result.path = std::move(cells);
+        return result;
+    }
+};
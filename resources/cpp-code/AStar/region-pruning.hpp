@@ -0,0 +1,376 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "grid-graph.hpp"
+#include "search-core.hpp"
+
+// Query-independent pruning of a GridGraph, built once per map.
+//
+// Dead ends: for every articulation cell a of the passable cells, each part
+// of the map that is cut off when a is removed can only be left again
+// through a, so a simple path between two cells outside that part never
+// enters it. Parts are DFS subtrees hanging off a ("separated" children in
+// Tarjan's algorithm) plus whatever remains on the root side.
+//
+// Swamps: small connected regions R such that, for every pair of cells x,
+// y bordering R, the cheapest x-y path that avoids R costs exactly as much
+// as the cheapest one overall. An optimal path through R can then always
+// be rerouted around it at no extra cost. Each region is verified on the
+// map minus the swamps already accepted, so all of them can be skipped
+// together, but only when neither endpoint lies in any swamp.
+class RegionPruning {
+public:
+    struct Articulation {
+        std::vector<std::pair<int, int>> parts;   // DFS-order intervals [first, last)
+        std::int8_t part_of_move[4];                // per neighbor direction, -1 = root side
+    };
+
+private:
+    const GridGraph& grid;
+    std::vector<int> order;
+    std::vector<int> articulation_of;
+    std::vector<Articulation> articulations;
+    std::vector<int> swamp_of;
+    int swamps;
+
+    static int direction(int node, int next, int cols) {
+        if (next == node + cols) {
+            return 0;
+        }
+        if (next == node + 1) {
+            return 1;
+        }
+        if (next == node - cols) {
+            return 2;
+        }
+        return 3;
+    }
+
+    void find_articulations() {
+        const int n = grid.node_count();
+        const int cols = grid.column_count();
+        order.assign(n, -1);
+        std::vector<int> low(n, 0);
+        std::vector<int> finish(n, 0);
+        std::vector<int> parent(n, -1);
+        std::vector<std::vector<int>> separated(n);
+        std::vector<std::pair<int, int>> stack;   // (node, next move to try)
+        int clock = 0;
+
+        for (int root = 0; root < n; root++) {
+            if (!grid.passable(root) || order[root] != -1) {
+                continue;
+            }
+            order[root] = low[root] = clock++;
+            stack.emplace_back(root, 0);
+            while (!stack.empty()) {
+                int node = stack.back().first;
+                int move = stack.back().second++;
+                if (move < 4) {
+                    int next = -1;
+                    grid.for_each_edge(node, [&](int neighbor, float) {
+                        if (direction(node, neighbor, cols) == move) {
+                            next = neighbor;
+                        }
+                    });
+                    if (next == -1 || next == parent[node]) {
+                        continue;
+                    }
+                    if (order[next] == -1) {
+                        parent[next] = node;
+                        order[next] = low[next] = clock++;
+                        stack.emplace_back(next, 0);
+                    } else {
+                        low[node] = std::min(low[node], order[next]);
+                    }
+                    continue;
+                }
+                finish[node] = clock;
+                stack.pop_back();
+                int up = parent[node];
+                if (up != -1) {
+                    low[up] = std::min(low[up], low[node]);
+                    if (low[node] >= order[up]) {
+                        separated[up].push_back(node);
+                    }
+                }
+            }
+            // The root only cuts the map when it has two DFS children.
+            if (separated[root].size() < 2) {
+                separated[root].clear();
+            }
+        }
+
+        articulation_of.assign(n, -1);
+        for (int node = 0; node < n; node++) {
+            if (separated[node].empty()) {
+                continue;
+            }
+            Articulation articulation;
+            for (int child : separated[node]) {
+                articulation.parts.emplace_back(order[child], finish[child]);
+            }
+            for (int move = 0; move < 4; move++) {
+                articulation.part_of_move[move] = -1;
+            }
+            grid.for_each_edge(node, [&](int next, float) {
+                articulation.part_of_move[direction(node, next, cols)] =
+                    static_cast<std::int8_t>(part_containing(articulation, order[next]));
+            });
+            articulation_of[node] = static_cast<int>(articulations.size());
+            articulations.push_back(std::move(articulation));
+        }
+    }
+
+    static int part_containing(const Articulation& articulation, int position) {
+        for (std::size_t part = 0; part < articulation.parts.size(); part++) {
+            if (position >= articulation.parts[part].first && position < articulation.parts[part].second) {
+                return static_cast<int>(part);
+            }
+        }
+        return -1;
+    }
+
+    // Cheapest costs from source to each cell of `targets`, avoiding cells
+    // for which blocked() holds; stops once every target is settled.
+    template <class Blocked>
+    std::vector<float> distances(int source, const std::vector<int>& targets, Blocked&& blocked,
+                                 std::vector<float>& distance, std::vector<int>& touched) const {
+        const float infinity = std::numeric_limits<float>::infinity();
+        std::vector<std::pair<float, int>> pending_queue;
+        std::size_t remaining = targets.size();
+        std::vector<char> wanted(targets.size(), 1);
+        distance[source] = 0.0f;
+        touched.push_back(source);
+        pending_queue.emplace_back(0.0f, source);
+        while (!pending_queue.empty() && remaining > 0) {
+            std::pop_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+            auto top = pending_queue.back();
+            pending_queue.pop_back();
+            if (top.first > distance[top.second]) {
+                continue;
+            }
+            for (std::size_t i = 0; i < targets.size(); i++) {
+                if (wanted[i] && targets[i] == top.second) {
+                    wanted[i] = 0;
+                    remaining--;
+                }
+            }
+            grid.for_each_edge(top.second, [&](int next, float weight) {
+                if (blocked(next)) {
+                    return;
+                }
+                float d = top.first + weight;
+                if (d < distance[next]) {
+                    if (distance[next] == infinity) {
+                        touched.push_back(next);
+                    }
+                    distance[next] = d;
+                    pending_queue.emplace_back(d, next);
+                    std::push_heap(pending_queue.begin(), pending_queue.end(), std::greater<>());
+                }
+            });
+        }
+        std::vector<float> result;
+        for (int target : targets) {
+            result.push_back(distance[target]);
+        }
+        for (int node : touched) {
+            distance[node] = infinity;
+        }
+        touched.clear();
+        return result;
+    }
+
+    bool is_swamp(const std::vector<int>& region, std::vector<int>& mark, int stamp,
+                  std::vector<float>& distance, std::vector<int>& touched) const {
+        for (int node : region) {
+            mark[node] = stamp;
+        }
+        std::vector<int> border;
+        for (int node : region) {
+            grid.for_each_edge(node, [&](int next, float) {
+                if (mark[next] != stamp && swamp_of[next] == -1 &&
+                    std::find(border.begin(), border.end(), next) == border.end()) {
+                    border.push_back(next);
+                }
+            });
+        }
+        auto outside_swamps = [&](int node) { return swamp_of[node] != -1; };
+        auto outside_region = [&](int node) { return swamp_of[node] != -1 || mark[node] == stamp; };
+        for (std::size_t i = 0; i + 1 < border.size(); i++) {
+            std::vector<int> rest(border.begin() + i + 1, border.end());
+            std::vector<float> with = distances(border[i], rest, outside_swamps, distance, touched);
+            std::vector<float> without = distances(border[i], rest, outside_region, distance, touched);
+            if (with != without) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Grows a region from every cell in turn, keeping each added neighbor
+    // while the region stays a swamp, up to max_region cells.
+    void find_swamps(int max_region) {
+        const int n = grid.node_count();
+        swamp_of.assign(n, -1);
+        swamps = 0;
+        if (max_region <= 0) {
+            return;
+        }
+        std::vector<int> mark(n, 0);
+        std::vector<float> distance(n, std::numeric_limits<float>::infinity());
+        std::vector<int> touched;
+        int stamp = 0;
+        for (int seed = 0; seed < n; seed++) {
+            if (!grid.passable(seed) || swamp_of[seed] != -1 || articulation_of[seed] != -1) {
+                continue;
+            }
+            std::vector<int> region{seed};
+            if (!is_swamp(region, mark, ++stamp, distance, touched)) {
+                continue;
+            }
+            for (std::size_t i = 0; i < region.size() && static_cast<int>(region.size()) < max_region; i++) {
+                std::vector<int> candidates;
+                grid.for_each_edge(region[i], [&](int next, float) {
+                    if (swamp_of[next] == -1 && articulation_of[next] == -1 &&
+                        std::find(region.begin(), region.end(), next) == region.end()) {
+                        candidates.push_back(next);
+                    }
+                });
+                for (int candidate : candidates) {
+                    if (static_cast<int>(region.size()) >= max_region) {
+                        break;
+                    }
+                    region.push_back(candidate);
+                    if (!is_swamp(region, mark, ++stamp, distance, touched)) {
+                        region.pop_back();
+                    }
+                }
+            }
+            for (int node : region) {
+                swamp_of[node] = swamps;
+            }
+            swamps++;
+        }
+    }
+
+public:
+    explicit RegionPruning(const GridGraph& grid_, int max_swamp_region = 8) : grid(grid_), swamps(0) {
+        find_articulations();
+        find_swamps(max_swamp_region);
+    }
+
+    const GridGraph& graph() const {
+        return grid;
+    }
+
+    std::size_t articulation_count() const {
+        return articulations.size();
+    }
+
+    int swamp_count() const {
+        return swamps;
+    }
+
+    int swamp_of_cell(int node) const {
+        return swamp_of[node];
+    }
+
+    int articulation_index(int node) const {
+        return articulation_of[node];
+    }
+
+    const Articulation& articulation(int index) const {
+        return articulations[index];
+    }
+
+    // Which part around articulation cell `node` holds `cell`: -2 for the
+    // articulation itself, -1 for the root side, else a part index.
+    int part_of(int node, int cell) const {
+        if (cell == node) {
+            return -2;
+        }
+        return part_containing(articulations[articulation_of[node]], order[cell]);
+    }
+
+    int move_of(int node, int next) const {
+        return direction(node, next, grid.column_count());
+    }
+};
+
+// GridGraph with RegionPruning applied for one query at a time;
+// set_query() must be called before each search. Away from articulation
+// cells the only extra work per edge is the swamp lookup.
+class PrunedGridGraph {
+private:
+    const RegionPruning& pruning;
+    const GridGraph& grid;
+    int initial;
+    int target;
+    bool skip_swamps;
+
+public:
+    explicit PrunedGridGraph(const RegionPruning& pruning_)
+        : pruning(pruning_), grid(pruning_.graph()), initial(-1), target(-1), skip_swamps(false) {}
+
+    void set_query(int initial_, int target_) {
+        initial = initial_;
+        target = target_;
+        skip_swamps = pruning.swamp_of_cell(initial) == -1 && pruning.swamp_of_cell(target) == -1;
+    }
+
+    int node_count() const {
+        return grid.node_count();
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        int index = pruning.articulation_index(node);
+        int initial_part = 0;
+        int target_part = 0;
+        if (index != -1) {
+            initial_part = pruning.part_of(node, initial);
+            target_part = pruning.part_of(node, target);
+        }
+        grid.for_each_edge(node, [&](int next, float weight) {
+            if (skip_swamps && pruning.swamp_of_cell(next) != -1) {
+                return;
+            }
+            if (index != -1) {
+                int part = pruning.articulation(index).part_of_move[pruning.move_of(node, next)];
+                if (part != initial_part && part != target_part) {
+                    return;
+                }
+            }
+            visit(next, weight);
+        });
+    }
+
+    float heuristic(int node, int target_) const {
+        return grid.heuristic(node, target_);
+    }
+};
+
+class PrunedSearch {
+private:
+    PrunedGridGraph graph;
+    SearchCore<PrunedGridGraph> core;
+
+public:
+    explicit PrunedSearch(const RegionPruning& pruning) : graph(pruning), core(graph) {}
+
+    PrunedSearch(const PrunedSearch&) = delete;
+    PrunedSearch& operator=(const PrunedSearch&) = delete;
+
+    SearchResult execute(int initial, int target) {
+        graph.set_query(initial, target);
+        return core.execute(initial, target);
+    }
+};
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "open-list.hpp"
+#include "perf-counters.hpp"
+#include "search-limits.hpp"
+
+struct SearchResult {
+    std::vector<int> path;
+    float cost = 0.0f;
+    bool found = false;
+    std::size_t expanded = 0;
+    bool partial = false;   // stopped by SearchLimits; path leads towards the target
+    int last_node = -1;     // where the path ends: the target, or the partial path's end
+};
+
+// A* over any graph that provides node_count(), for_each_edge() and
+// heuristic() (see GridGraph and CsrGraph). Per-node state lives in flat
+// arrays indexed by node id and is invalidated by bumping a generation
+// stamp, so one SearchCore can serve many queries without clearing memory.
+// Like BFS::execute(), processed nodes are never reopened. The open list
+// is a policy from open-list.hpp; every policy gives the same results.
+// Probe is told where each search and each phase of an expansion begins
+// (see perf-counters.hpp); the default NullProbe costs nothing.
+template <class Graph, class OpenList = BinaryOpenList, class Probe = NullProbe>
+class SearchCore {
+private:
+    const Graph& graph;
+    std::vector<float> weight_a;
+    std::vector<int> predecessor;
+    std::vector<std::uint32_t> seen;
+    std::vector<std::uint32_t> processed;
+    std::uint32_t generation;
+    OpenList pending_queue;
+    Probe phase_probe;
+    std::vector<std::uint32_t> goal_mark;   // sized on the first multi-goal query
+    std::uint32_t goal_round = 0;
+
+    void next_generation() {
+        if (++generation == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            std::fill(processed.begin(), processed.end(), 0);
+            generation = 1;
+        }
+    }
+
+public:
+    explicit SearchCore(const Graph& graph_)
+        : graph(graph_),
+          weight_a(graph_.node_count()), predecessor(graph_.node_count()),
+          seen(graph_.node_count(), 0), processed(graph_.node_count(), 0), generation(0) {}
+
+    Probe& probe() {
+        return phase_probe;
+    }
+
+    SearchResult execute(int initial, int target) {
+        return with_path(solve(initial, target));
+    }
+
+    SearchResult execute(int initial, int target, const SearchLimits& limits) {
+        return with_path(solve(initial, target, limits));
+    }
+
+    // Runs the search but leaves the path in the predecessor array, for
+    // callers that copy it straight into their own storage with
+    // path_length() and write_path().
+    SearchResult solve(int initial, int target) {
+        return run<false>(initial, [target](int node) { return node == target; },
+                          [this, target](int node) { return graph.heuristic(node, target); }, SearchLimits());
+    }
+
+    // As solve(), but gives up once `limits` is reached. The result is then
+    // marked partial and leads to the reached node with the lowest
+    // heuristic (the cheaper one on ties), for callers that start moving
+    // and replan.
+    SearchResult solve(int initial, int target, const SearchLimits& limits) {
+        return run<true>(initial, [target](int node) { return node == target; },
+                         [this, target](int node) { return graph.heuristic(node, target); }, limits);
+    }
+
+    // Cheapest path from initial to the nearest of `goals` in one search,
+    // stopping at the first goal popped; last_node tells which one. The
+    // heuristic is the minimum of graph.heuristic() over the goals, which
+    // costs one call per goal and push.
+    SearchResult solve_nearest(int initial, const std::vector<int>& goals) {
+        return solve_nearest(initial, goals, [&](int node) {
+            float h = std::numeric_limits<float>::infinity();
+            for (int goal : goals) {
+                h = std::min(h, graph.heuristic(node, goal));
+            }
+            return h;
+        });
+    }
+
+    // As above with a caller-supplied estimate of the cost to the nearest
+    // goal, e.g. NearestGoalField::heuristic() for large goal sets.
+    template <class Heuristic>
+    SearchResult solve_nearest(int initial, const std::vector<int>& goals, Heuristic&& heuristic) {
+        if (goal_mark.empty()) {
+            goal_mark.assign(graph.node_count(), 0);
+        }
+        if (++goal_round == 0) {
+            std::fill(goal_mark.begin(), goal_mark.end(), 0);
+            goal_round = 1;
+        }
+        for (int goal : goals) {
+            goal_mark[goal] = goal_round;
+        }
+        const std::uint32_t round = goal_round;
+        return run<false>(initial, [this, round](int node) { return goal_mark[node] == round; }, heuristic,
+                          SearchLimits());
+    }
+
+    SearchResult execute_nearest(int initial, const std::vector<int>& goals) {
+        return with_path(solve_nearest(initial, goals));
+    }
+
+    template <class Heuristic>
+    SearchResult execute_nearest(int initial, const std::vector<int>& goals, Heuristic&& heuristic) {
+        return with_path(solve_nearest(initial, goals, heuristic));
+    }
+
+private:
+    SearchResult with_path(SearchResult result) const {
+        if (result.last_node != -1) {
+            result.path = find_list(result.last_node);
+        }
+        return result;
+    }
+
+    template <bool Limited, class IsGoal, class Heuristic>
+    SearchResult run(int initial, IsGoal&& is_goal, Heuristic&& heuristic, const SearchLimits& limits) {
+        SearchResult result;
+        phase_probe.begin();
+        next_generation();
+        pending_queue.clear();
+
+        weight_a[initial] = 0.0f;
+        predecessor[initial] = -1;
+        seen[initial] = generation;
+        int best_node = initial;
+        float best_h = heuristic(initial);
+        pending_queue.push(best_h, initial);
+
+        while (!pending_queue.empty()) {
+            phase_probe.enter(PHASE_POP);
+            int current = pending_queue.pop().second;
+
+            phase_probe.enter(PHASE_CLOSED_CHECK);
+            if (processed[current] == generation) {
+                continue;
+            }
+            if (Limited && !is_goal(current) && limits.reached(result.expanded)) {
+                result.partial = true;
+                result.cost = weight_a[best_node];
+                result.last_node = best_node;
+                phase_probe.end();
+                return result;
+            }
+            processed[current] = generation;
+            result.expanded++;
+
+            if (is_goal(current)) {
+                result.found = true;
+                result.cost = weight_a[current];
+                result.last_node = current;
+                phase_probe.end();
+                return result;
+            }
+
+            const float base = weight_a[current];
+            auto relax = [&](int next, float weight) {
+                if (processed[next] == generation) {
+                    return;
+                }
+                float g = base + weight;
+                if (seen[next] == generation && weight_a[next] <= g) {
+                    return;
+                }
+                seen[next] = generation;
+                weight_a[next] = g;
+                predecessor[next] = current;
+                float h = heuristic(next);
+                if (Limited && (h < best_h || (h == best_h && g < weight_a[best_node]))) {
+                    best_node = next;
+                    best_h = h;
+                }
+                pending_queue.push(g + h, next);
+            };
+            phase_probe.enter(PHASE_NEIGHBORS);
+            graph.for_each_edge(current, [&](int next, float weight) {
+                phase_probe.enter(PHASE_RELAX);
+                relax(next, weight);
+                phase_probe.enter(PHASE_NEIGHBORS);
+            });
+        }
+        phase_probe.end();
+        return result;
+    }
+
+public:
+    std::vector<int> find_list(int final_node) const {
+        std::vector<int> sequence;
+        for (int node = final_node; node != -1; node = predecessor[node]) {
+            sequence.push_back(node);
+        }
+        std::reverse(sequence.begin(), sequence.end());
+        return sequence;
+    }
+
+    std::size_t path_length(int final_node) const {
+        std::size_t length = 0;
+        for (int node = final_node; node != -1; node = predecessor[node]) {
+            length++;
+        }
+        return length;
+    }
+
+    // Writes path_length(final_node) entries, start first, converting each
+    // node with convert(node).
+    template <class Out, class Convert>
+    void write_path(int final_node, Out* out, Convert&& convert) const {
+        std::size_t i = path_length(final_node);
+        for (int node = final_node; node != -1; node = predecessor[node]) {
+            out[--i] = convert(node);
+        }
+    }
+};
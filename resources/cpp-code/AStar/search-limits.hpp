@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+// Set from any thread to stop the searches that were given this token.
+class CancellationToken {
+private:
+    std::atomic<bool> flag{false};
+
+public:
+    void cancel() {
+        flag.store(true, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        flag.store(false, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const {
+        return flag.load(std::memory_order_relaxed);
+    }
+};
+
+// When a search has to give up. Every field is optional; a search stops at
+// whichever comes first. The token is checked on each expansion, the clock
+// only every clock_interval expansions (0 counts as 1: every expansion).
+struct SearchLimits {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    std::size_t max_expansions = 0;   // 0 = no limit
+    const CancellationToken* token = nullptr;
+    std::size_t clock_interval = 64;
+
+    static SearchLimits within(std::chrono::microseconds budget) {
+        SearchLimits limits;
+        limits.deadline = std::chrono::steady_clock::now() + budget;
+        return limits;
+    }
+
+    static SearchLimits expansions(std::size_t count) {
+        SearchLimits limits;
+        limits.max_expansions = count;
+        return limits;
+    }
+
+    bool reached(std::size_t expanded) const {
+        if (max_expansions != 0 && expanded >= max_expansions) {
+            return true;
+        }
+        if (token != nullptr && token->cancelled()) {
+            return true;
+        }
+        return (clock_interval <= 1 || expanded % clock_interval == 0) && deadline != std::chrono::steady_clock::time_point::max() &&
+               std::chrono::steady_clock::now() >= deadline;
+    }
+};
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <new>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "path-protocol.hpp"
+
+// Process-shared futex on a 32-bit word inside the mapping.
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected, const timespec* timeout) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+inline void futex_wake(std::atomic<std::uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+// Spins for a while before sleeping on the futex, so a busy peer never
+// costs a syscall; only a ring that has gone idle does. Sleeps are bounded
+// to 50 ms and keep_waiting() is asked after each; returns false once it
+// says no.
+template <class Ready, class KeepWaiting>
+bool wait_while(std::atomic<std::uint32_t>& word, std::atomic<std::uint32_t>& sleepers, Ready&& ready,
+                KeepWaiting&& keep_waiting) {
+    for (int spin = 0; spin < 4096; spin++) {
+        if (ready()) {
+            return true;
+        }
+    }
+    const timespec poll = {0, 50 * 1000 * 1000};
+    while (!ready()) {
+        if (!keep_waiting()) {
+            return false;
+        }
+        std::uint32_t observed = word.load();
+        sleepers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            futex_wait(word, observed, &poll);
+        }
+        sleepers.fetch_sub(1);
+    }
+    return true;
+}
+
+// wait_while() until `stop` is set, or for good without one.
+template <class Ready>
+bool wait_on(std::atomic<std::uint32_t>& word, std::atomic<std::uint32_t>& sleepers, Ready&& ready,
+             const std::atomic<bool>* stop = nullptr) {
+    return wait_while(word, sleepers, ready, [stop]() { return stop == nullptr || !stop->load(); });
+}
+
+inline void publish(std::atomic<std::uint32_t>& word, std::uint32_t value, std::atomic<std::uint32_t>& sleepers) {
+    word.store(value);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load() != 0) {
+        futex_wake(word);
+    }
+}
+
+// Lock-free single-producer/single-consumer ring living in shared memory.
+// head and tail are free-running 32-bit counters; each sits on its own
+// cache line and doubles as the futex word the other side sleeps on.
+template <class T, std::uint32_t Capacity>
+struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+    alignas(64) std::atomic<std::uint32_t> head;
+    std::atomic<std::uint32_t> head_sleepers;
+    alignas(64) std::atomic<std::uint32_t> tail;
+    std::atomic<std::uint32_t> tail_sleepers;
+    alignas(64) T slots[Capacity];
+
+    bool try_push(const T& value) {
+        std::uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[t & (Capacity - 1)] = value;
+        publish(tail, t + 1, tail_sleepers);
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        std::uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[h & (Capacity - 1)];
+        publish(head, h + 1, head_sleepers);
+        return true;
+    }
+
+    template <class KeepWaiting>
+    bool push_while(const T& value, KeepWaiting&& keep_waiting) {
+        bool ready = wait_while(head, head_sleepers, [&]() {
+            return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) != Capacity;
+        }, keep_waiting);
+        return ready && try_push(value);
+    }
+
+    template <class KeepWaiting>
+    bool pop_while(T& value, KeepWaiting&& keep_waiting) {
+        bool ready = wait_while(tail, tail_sleepers, [&]() {
+            return head.load(std::memory_order_relaxed) != tail.load(std::memory_order_acquire);
+        }, keep_waiting);
+        return ready && try_pop(value);
+    }
+
+    bool push(const T& value, const std::atomic<bool>* stop = nullptr) {
+        return push_while(value, [stop]() { return stop == nullptr || !stop->load(); });
+    }
+
+    bool pop(T& value, const std::atomic<bool>* stop) {
+        return pop_while(value, [stop]() { return stop == nullptr || !stop->load(); });
+    }
+};
+
+// Cell arena for result paths. The engine allocates contiguous blocks in
+// order and writes paths into them directly; the client releases them in
+// the same order once it has read them. A block never wraps: when it would,
+// the rest of the buffer is skipped and freed together with the block.
+template <std::uint32_t Capacity>
+struct PathArena {
+    static_assert((Capacity & (Capacity - 1)) == 0, "arena capacity must be a power of two");
+
+    alignas(64) std::atomic<std::uint32_t> head;
+    std::atomic<std::uint32_t> head_sleepers;
+    alignas(64) std::uint32_t tail;
+    alignas(64) PathCell cells[Capacity];
+
+    static constexpr std::uint32_t capacity() {
+        return Capacity;
+    }
+
+    // Producer side; blocks while the client still holds the space. Sets
+    // position to the arena position of the block.
+    bool allocate(std::uint32_t length, std::uint32_t& position, const std::atomic<bool>* stop = nullptr) {
+        std::uint32_t index = tail & (Capacity - 1);
+        std::uint32_t skip = index + length > Capacity ? Capacity - index : 0;
+        std::uint32_t end = tail + skip + length;
+        if (!wait_on(head, head_sleepers, [&]() { return end - head.load(std::memory_order_acquire) <= Capacity; }, stop)) {
+            return false;
+        }
+        position = tail + skip;
+        tail = end;
+        return true;
+    }
+
+    PathCell* at(std::uint32_t position) {
+        return cells + (position & (Capacity - 1));
+    }
+
+    void release(std::uint32_t end) {
+        publish(head, end, head_sleepers);
+    }
+};
+
+struct ShmQuery {
+    std::uint32_t request_id;
+    std::uint32_t map_id;
+    std::int32_t start_row;
+    std::int32_t start_col;
+    std::int32_t goal_row;
+    std::int32_t goal_col;
+};
+
+struct ShmResult {
+    std::uint32_t request_id;
+    std::uint32_t status;
+    float cost;
+    std::uint32_t path_position;
+    std::uint32_t length;
+};
+
+// One query ring, one result ring and a path arena for one client process.
+// server_pid is the engine process while it serves the channel and 0 once
+// it has stopped, so a client can tell a slow engine from a dead one.
+struct ShmChannel {
+    static constexpr std::uint32_t MAGIC = 0x41535453;
+
+    std::uint32_t magic;
+    std::atomic<std::uint32_t> server_pid;
+    SpscRing<ShmQuery, 4096> queries;
+    SpscRing<ShmResult, 4096> results;
+    PathArena<1u << 20> arena;
+};
+
+// Maps a ShmChannel backed by a POSIX shared-memory object. The engine side
+// creates and initializes it; clients attach to an existing one.
+class ShmMapping {
+private:
+    std::string name;
+    ShmChannel* channel;
+    bool owner;
+
+public:
+    ShmMapping(const std::string& name_, bool create) : name(name_), channel(nullptr), owner(create) {
+        int fd = shm_open(name.c_str(), create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open shared memory " + name);
+        }
+        if (create && ftruncate(fd, sizeof(ShmChannel)) != 0) {
+            close(fd);
+            throw std::runtime_error("cannot size shared memory " + name);
+        }
+        void* memory = mmap(nullptr, sizeof(ShmChannel), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            throw std::runtime_error("cannot map shared memory " + name);
+        }
+        channel = static_cast<ShmChannel*>(memory);
+        if (create) {
+            new (&channel->queries.head) std::atomic<std::uint32_t>(0);
+            new (&channel->queries.head_sleepers) std::atomic<std::uint32_t>(0);
+            new (&channel->queries.tail) std::atomic<std::uint32_t>(0);
+            new (&channel->queries.tail_sleepers) std::atomic<std::uint32_t>(0);
+            new (&channel->results.head) std::atomic<std::uint32_t>(0);
+            new (&channel->results.head_sleepers) std::atomic<std::uint32_t>(0);
+            new (&channel->results.tail) std::atomic<std::uint32_t>(0);
+            new (&channel->results.tail_sleepers) std::atomic<std::uint32_t>(0);
+            new (&channel->arena.head) std::atomic<std::uint32_t>(0);
+            new (&channel->arena.head_sleepers) std::atomic<std::uint32_t>(0);
+            channel->arena.tail = 0;
+            new (&channel->server_pid) std::atomic<std::uint32_t>(static_cast<std::uint32_t>(getpid()));
+            std::atomic_thread_fence(std::memory_order_release);
+            channel->magic = ShmChannel::MAGIC;
+        } else if (channel->magic != ShmChannel::MAGIC) {
+            munmap(channel, sizeof(ShmChannel));
+            throw std::runtime_error("shared memory " + name + " is not a path channel");
+        }
+    }
+
+    ShmMapping(const ShmMapping&) = delete;
+    ShmMapping& operator=(const ShmMapping&) = delete;
+
+    ~ShmMapping() {
+        if (owner) {
+            channel->server_pid.store(0);
+        }
+        munmap(channel, sizeof(ShmChannel));
+        if (owner) {
+            shm_unlink(name.c_str());
+        }
+    }
+
+    ShmChannel& get() {
+        return *channel;
+    }
+};
+
+// Client side: submit queries, receive results, read paths in place.
+// submit() and receive() throw std::runtime_error instead of blocking once
+// the engine has stopped or died, or after waiting `timeout` for it. A
+// result that arrives after a timeout is returned by the next receive().
+class ShmPathClient {
+private:
+    std::string name;
+    ShmMapping mapping;
+    std::chrono::milliseconds timeout;
+
+    bool engine_alive() {
+        auto pid = static_cast<pid_t>(mapping.get().server_pid.load());
+        return pid != 0 && (kill(pid, 0) == 0 || errno == EPERM);
+    }
+
+    // keep_waiting() for the rings; leaves the reason to give up in `why`.
+    auto waiting(const char*& why) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        return [this, deadline, &why]() {
+            if (!engine_alive()) {
+                why = "path engine is gone";
+                return false;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                why = "timed out waiting for the path engine";
+                return false;
+            }
+            return true;
+        };
+    }
+
+public:
+    explicit ShmPathClient(const std::string& name_, std::chrono::milliseconds timeout_ = std::chrono::seconds(30))
+        : name(name_), mapping(name_, false), timeout(timeout_) {}
+
+    void submit(const ShmQuery& query) {
+        const char* why = "";
+        if (!mapping.get().queries.push_while(query, waiting(why))) {
+            throw std::runtime_error("shared memory " + name + ": " + why);
+        }
+    }
+
+    ShmResult receive() {
+        const char* why = "";
+        ShmResult result;
+        if (!mapping.get().results.pop_while(result, waiting(why))) {
+            throw std::runtime_error("shared memory " + name + ": " + why);
+        }
+        return result;
+    }
+
+    const PathCell* path(const ShmResult& result) {
+        return mapping.get().arena.at(result.path_position);
+    }
+
+    // Results must be released in the order they were received.
+    void release(const ShmResult& result) {
+        if (result.length > 0) {
+            mapping.get().arena.release(result.path_position + result.length);
+        }
+    }
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "grid-graph.hpp"
+#include "open-list.hpp"
+#include "search-core.hpp"
+
+// SearchCore<GridGraph> specialised for 4-connected grids, relaxing all
+// four neighbors of an expanded cell at once: their costs, search stamps
+// and g values are gathered into 4-lane vectors, new g, h and f and the
+// improvement mask are computed together, and only the improved lanes are
+// visited to update state and push. Results, including the expansion
+// order, are identical to SearchCore<GridGraph, OpenList>.
+//
+// Cells live in a copy of the grid padded with a ring of walls, so the
+// neighbors of any cell are at fixed offsets (+width, +1, -width, -1) and
+// need no bounds checks. Per-cell state is one stamp instead of SearchCore's
+// seen/processed pair: 2 * generation while the cell is open and
+// 2 * generation + 1 once it is processed. Uses AVX2 gathers when built
+// with -mavx2 (or -march=native), SSE2 otherwise, and plain loops on
+// other targets.
+template <class OpenList = BinaryOpenList>
+class SimdGridSearch {
+private:
+    int rows;
+    int cols;
+    int width;                        // cols + 2
+    std::vector<float> costs;         // padded; walls and the ring are -1
+    std::vector<float> weight_a;
+    std::vector<int> predecessor;
+    std::vector<std::uint32_t> stamp;
+    std::uint32_t generation;
+    OpenList pending_queue;
+
+    int padded(int node) const {
+        return (node / cols + 1) * width + node % cols + 1;
+    }
+
+    int unpadded(int cell) const {
+        return (cell / width - 1) * cols + cell % width - 1;
+    }
+
+    void next_generation() {
+        if (++generation >= 0x7fffffffu) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+public:
+    explicit SimdGridSearch(const GridGraph& grid)
+        : rows(grid.row_count()), cols(grid.column_count()), width(grid.column_count() + 2),
+          costs(static_cast<std::size_t>(rows + 2) * width, -1.0f),
+          weight_a(costs.size()), predecessor(costs.size()), stamp(costs.size(), 0), generation(0) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                costs[static_cast<std::size_t>(r + 1) * width + c + 1] = static_cast<float>(grid.cost(grid.node(r, c)));
+            }
+        }
+    }
+
+    SearchResult execute(int initial, int target) {
+        SearchResult result = solve(initial, target);
+        if (result.found) {
+            result.path = find_list(result.last_node);
+        }
+        return result;
+    }
+
+    // Like SearchCore::solve(): the path stays in the predecessor array.
+    // Node ids are GridGraph ids.
+    SearchResult solve(int initial, int target) {
+        SearchResult result;
+        next_generation();
+        pending_queue.clear();
+        const std::uint32_t open = 2 * generation;
+        const std::uint32_t closed = open + 1;
+        const int start = padded(initial);
+        const int goal = padded(target);
+        const int goal_r = goal / width;
+        const int goal_c = goal % width;
+
+        weight_a[start] = 0.0f;
+        predecessor[start] = -1;
+        stamp[start] = open;
+        pending_queue.push(static_cast<float>(std::abs(start / width - goal_r) + std::abs(start % width - goal_c)),
+                           start);
+
+        const int offsets[4] = {width, 1, -width, -1};   // down, right, up, left, as GridGraph
+        while (!pending_queue.empty()) {
+            int current = pending_queue.pop().second;
+            if (stamp[current] == closed) {
+                continue;
+            }
+            stamp[current] = closed;
+            result.expanded++;
+            if (current == goal) {
+                result.found = true;
+                result.cost = weight_a[current];
+                result.last_node = target;
+                return result;
+            }
+
+            const float base = weight_a[current];
+            const int r = current / width;
+            const int c = current % width;
+            alignas(16) float g[4];
+            alignas(16) float f[4];
+            int improved;
+#if defined(__SSE2__)
+#if defined(__AVX2__)
+            const __m128i cells = _mm_add_epi32(_mm_set1_epi32(current), _mm_setr_epi32(width, 1, -width, -1));
+            const __m128 cost = _mm_i32gather_ps(costs.data(), cells, 4);
+            const __m128 old_g = _mm_i32gather_ps(weight_a.data(), cells, 4);
+            const __m128i state = _mm_i32gather_epi32(reinterpret_cast<const int*>(stamp.data()), cells, 4);
+#else
+            const __m128 cost = _mm_setr_ps(costs[current + width], costs[current + 1], costs[current - width],
+                                            costs[current - 1]);
+            const __m128 old_g = _mm_setr_ps(weight_a[current + width], weight_a[current + 1],
+                                             weight_a[current - width], weight_a[current - 1]);
+            const __m128i state = _mm_setr_epi32(static_cast<int>(stamp[current + width]),
+                                                 static_cast<int>(stamp[current + 1]),
+                                                 static_cast<int>(stamp[current - width]),
+                                                 static_cast<int>(stamp[current - 1]));
+#endif
+            const __m128 new_g = _mm_add_ps(_mm_set1_ps(base), cost);
+            // |row - goal row| + |col - goal col| for the four neighbors.
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            const __m128 dr = _mm_andnot_ps(sign, _mm_cvtepi32_ps(_mm_sub_epi32(
+                _mm_add_epi32(_mm_set1_epi32(r), _mm_setr_epi32(1, 0, -1, 0)), _mm_set1_epi32(goal_r))));
+            const __m128 dc = _mm_andnot_ps(sign, _mm_cvtepi32_ps(_mm_sub_epi32(
+                _mm_add_epi32(_mm_set1_epi32(c), _mm_setr_epi32(0, 1, 0, -1)), _mm_set1_epi32(goal_c))));
+            const __m128 passable = _mm_cmpge_ps(cost, _mm_setzero_ps());
+            const __m128 is_open = _mm_castsi128_ps(_mm_cmpeq_epi32(state, _mm_set1_epi32(static_cast<int>(open))));
+            const __m128 is_closed = _mm_castsi128_ps(_mm_cmpeq_epi32(state, _mm_set1_epi32(static_cast<int>(closed))));
+            // Open cells improve only on a strictly lower g, as in SearchCore.
+            const __m128 better = _mm_or_ps(_mm_andnot_ps(is_open, _mm_castsi128_ps(_mm_set1_epi32(-1))),
+                                            _mm_cmplt_ps(new_g, old_g));
+            improved = _mm_movemask_ps(_mm_and_ps(_mm_andnot_ps(is_closed, passable), better));
+            _mm_store_ps(g, new_g);
+            _mm_store_ps(f, _mm_add_ps(new_g, _mm_add_ps(dr, dc)));
+#else
+            const int lane_r[4] = {r + 1, r, r - 1, r};
+            const int lane_c[4] = {c, c + 1, c, c - 1};
+            improved = 0;
+            for (int lane = 0; lane < 4; lane++) {
+                const int next = current + offsets[lane];
+                g[lane] = base + costs[next];
+                f[lane] = g[lane] + static_cast<float>(std::abs(lane_r[lane] - goal_r) + std::abs(lane_c[lane] - goal_c));
+                bool better = stamp[next] != open || g[lane] < weight_a[next];
+                improved |= (costs[next] >= 0.0f && stamp[next] != closed && better) << lane;
+            }
+#endif
+            while (improved != 0) {
+                const int lane = __builtin_ctz(static_cast<unsigned>(improved));
+                improved &= improved - 1;
+                const int next = current + offsets[lane];
+                stamp[next] = open;
+                weight_a[next] = g[lane];
+                predecessor[next] = current;
+                pending_queue.push(f[lane], next);
+            }
+        }
+        return result;
+    }
+
+    std::vector<int> find_list(int final_node) const {
+        std::vector<int> sequence;
+        for (int cell = padded(final_node); cell != -1; cell = predecessor[cell]) {
+            sequence.push_back(unpadded(cell));
+        }
+        std::reverse(sequence.begin(), sequence.end());
+        return sequence;
+    }
+};
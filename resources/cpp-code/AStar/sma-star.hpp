@@ -0,0 +1,288 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <tuple>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+#include "search-core.hpp"
+
+struct BoundedSearchResult : SearchResult {
+    bool budget_hit = false;
+    std::size_t peak_nodes = 0;
+};
+
+// Memory-bounded A* (SMA*, in its graph-search form) over the same graph
+// concept as SearchCore. At most max_nodes search nodes exist at once.
+// When the budget is full, the worst frontier leaf (highest f, then
+// shallowest) is evicted and its f is backed up into its parent, which
+// goes back on the open list keyed by the best f it has forgotten and
+// regenerates the lost successors when that f becomes the lowest again.
+//
+// Every ancestor of a node stays in memory, so the path is always
+// recoverable, and a path that is found is optimal when the optimal path
+// fits in the budget. As in SMA*, a non-goal node as deep as the budget
+// gets f = infinity, since no path through it fits. budget_hit tells
+// whether the search ever ran out of room.
+//
+// With a tight budget, graph SMA* can thrash for a very long time,
+// re-deriving the same cells through different routes at the same f. The
+// search gives up after max_expansions expansions (by default 64 per graph
+// node) and reports not found.
+template <class Graph>
+class MemoryBoundedSearch {
+private:
+    static constexpr float INF = std::numeric_limits<float>::infinity();
+
+    struct Node {
+        int state;
+        int parent;
+        int depth;
+        int edge_index;
+        float weight_a;
+        float own_weight;
+        float total_weight;
+        float forgotten;
+        std::uint64_t forgotten_edges;
+        int first_child;
+        int next_sibling;
+        int prev_sibling;
+        bool expanded;
+        bool queued;
+    };
+
+    enum Eviction { EVICTED, KEEP_OTHERS, NO_ROOM };
+
+    const Graph& graph;
+    std::size_t max_nodes;
+    std::size_t max_expansions;
+    std::vector<Node> nodes;
+    std::vector<int> free_slots;
+    std::size_t live;
+    std::set<std::tuple<float, int, int>> pending_queue;
+    std::unordered_map<int, int> node_of_state;
+
+    std::tuple<float, int, int> key(int id) const {
+        return std::make_tuple(nodes[id].total_weight, -nodes[id].depth, id);
+    }
+
+    void enqueue(int id) {
+        if (!nodes[id].queued) {
+            pending_queue.insert(key(id));
+            nodes[id].queued = true;
+        }
+    }
+
+    void dequeue(int id) {
+        if (nodes[id].queued) {
+            pending_queue.erase(key(id));
+            nodes[id].queued = false;
+        }
+    }
+
+    void set_total_weight(int id, float f) {
+        bool queued = nodes[id].queued;
+        dequeue(id);
+        nodes[id].total_weight = f;
+        if (queued) {
+            enqueue(id);
+        }
+    }
+
+    int allocate(const Node& node) {
+        int id;
+        if (!free_slots.empty()) {
+            id = free_slots.back();
+            free_slots.pop_back();
+            nodes[id] = node;
+        } else {
+            id = static_cast<int>(nodes.size());
+            nodes.push_back(node);
+        }
+        live++;
+        return id;
+    }
+
+    void link_child(int parent, int child) {
+        nodes[child].parent = parent;
+        nodes[child].prev_sibling = -1;
+        nodes[child].next_sibling = nodes[parent].first_child;
+        if (nodes[parent].first_child != -1) {
+            nodes[nodes[parent].first_child].prev_sibling = child;
+        }
+        nodes[parent].first_child = child;
+    }
+
+    void unlink_child(int child) {
+        Node& node = nodes[child];
+        if (node.prev_sibling != -1) {
+            nodes[node.prev_sibling].next_sibling = node.next_sibling;
+        } else {
+            nodes[node.parent].first_child = node.next_sibling;
+        }
+        if (node.next_sibling != -1) {
+            nodes[node.next_sibling].prev_sibling = node.prev_sibling;
+        }
+    }
+
+    // Edges past the 64th are not tracked; their successors come back with
+    // their own f instead of the one backed up into the parent.
+    static std::uint64_t edge_bit(int index) {
+        return index < 64 ? 1ULL << index : 0;
+    }
+
+    // Frees the worst leaf, other than `keep`, if it ranks below a new node
+    // with the given f and depth would.
+    Eviction evict(int keep, float f, int depth) {
+        auto incoming = std::make_tuple(f, -depth);
+        for (auto it = pending_queue.rbegin(); it != pending_queue.rend(); ++it) {
+            int id = std::get<2>(*it);
+            const Node& node = nodes[id];
+            if (id == keep || node.first_child != -1 || node.parent == -1) {
+                continue;
+            }
+            if (std::make_tuple(node.total_weight, -node.depth) < incoming) {
+                return KEEP_OTHERS;
+            }
+            int parent = node.parent;
+            dequeue(id);
+            unlink_child(id);
+            node_of_state.erase(node.state);
+            free_slots.push_back(id);
+            live--;
+            nodes[parent].forgotten = std::min(nodes[parent].forgotten, node.total_weight);
+            nodes[parent].forgotten_edges |= edge_bit(node.edge_index);
+            if (nodes[parent].expanded) {
+                set_total_weight(parent, nodes[parent].forgotten);
+            }
+            return EVICTED;
+        }
+        return NO_ROOM;
+    }
+
+public:
+    MemoryBoundedSearch(const Graph& graph_, std::size_t max_nodes_, std::size_t max_expansions_ = 0)
+        : graph(graph_),
+          max_nodes(std::max<std::size_t>(max_nodes_, 1)),
+          max_expansions(max_expansions_ != 0 ? max_expansions_ : 64 * static_cast<std::size_t>(graph_.node_count())),
+          live(0) {}
+
+    // Approximate bytes one search node costs: the node itself, its open
+    // list entry and its entry in the state table.
+    static constexpr std::size_t bytes_per_node() {
+        return sizeof(Node) + 48 + 32;
+    }
+
+    static MemoryBoundedSearch with_byte_budget(const Graph& graph, std::size_t bytes) {
+        return MemoryBoundedSearch(graph, bytes / bytes_per_node());
+    }
+
+    BoundedSearchResult execute(int initial, int target) {
+        BoundedSearchResult result;
+        nodes.clear();
+        free_slots.clear();
+        pending_queue.clear();
+        node_of_state.clear();
+        live = 0;
+        nodes.reserve(std::min(max_nodes, static_cast<std::size_t>(graph.node_count())));
+
+        float h = graph.heuristic(initial, target);
+        int root = allocate({initial, -1, 0, -1, 0.0f, h, h, INF, 0, -1, -1, -1, false, false});
+        node_of_state[initial] = root;
+        enqueue(root);
+        result.peak_nodes = 1;
+
+        while (!pending_queue.empty()) {
+            int current = std::get<2>(*pending_queue.begin());
+            if (nodes[current].total_weight == INF || result.expanded >= max_expansions) {
+                break;
+            }
+            if (nodes[current].state == target) {
+                result.found = true;
+                result.cost = nodes[current].weight_a;
+                for (int id = current; id != -1; id = nodes[id].parent) {
+                    result.path.push_back(nodes[id].state);
+                }
+                std::reverse(result.path.begin(), result.path.end());
+                return result;
+            }
+
+            dequeue(current);
+            float backed_up = nodes[current].total_weight;
+            std::uint64_t regenerate = nodes[current].forgotten_edges;
+            nodes[current].expanded = true;
+            nodes[current].forgotten = INF;
+            nodes[current].forgotten_edges = 0;
+            result.expanded++;
+
+            int index = -1;
+            graph.for_each_edge(nodes[current].state, [&](int next, float weight) {
+                index++;
+                float g = nodes[current].weight_a + weight;
+                float own = std::max(nodes[current].own_weight, g + graph.heuristic(next, target));
+                int depth = nodes[current].depth + 1;
+                if (next != target && static_cast<std::size_t>(depth) + 1 >= max_nodes) {
+                    own = INF;
+                }
+                // Only a successor this node itself forgot may inherit the
+                // f backed up from it; any other bound could overestimate.
+                float f = (regenerate & edge_bit(index)) ? std::max(backed_up, own) : own;
+
+                auto known = node_of_state.find(next);
+                if (known != node_of_state.end()) {
+                    // A cheaper route moves the node, with whatever subtree it
+                    // has, under the current one. Unlike SearchCore this may
+                    // reopen an expanded node: an evicted cell can come back
+                    // through a worse route before the better one is seen.
+                    // What it backed up was measured from its old g, so it
+                    // starts over from its own f.
+                    int other = known->second;
+                    if (nodes[other].weight_a <= g) {
+                        return;
+                    }
+                    unlink_child(other);
+                    link_child(current, other);
+                    dequeue(other);
+                    nodes[other].depth = depth;
+                    nodes[other].edge_index = index;
+                    nodes[other].weight_a = g;
+                    nodes[other].own_weight = own;
+                    nodes[other].total_weight = own;
+                    nodes[other].forgotten = INF;
+                    nodes[other].forgotten_edges = 0;
+                    nodes[other].expanded = false;
+                    enqueue(other);
+                    return;
+                }
+
+                if (live >= max_nodes) {
+                    result.budget_hit = true;
+                    Eviction eviction = evict(current, f, depth);
+                    if (eviction == KEEP_OTHERS) {
+                        nodes[current].forgotten = std::min(nodes[current].forgotten, f);
+                        nodes[current].forgotten_edges |= edge_bit(index);
+                    }
+                    if (eviction != EVICTED) {
+                        return;
+                    }
+                }
+                int child = allocate({next, current, depth, index, g, own, f, INF, 0, -1, -1, -1, false, false});
+                link_child(current, child);
+                node_of_state[next] = child;
+                enqueue(child);
+                result.peak_nodes = std::max(result.peak_nodes, live);
+            });
+
+            // Successors that did not fit are remembered by their best f.
+            // With none, the node waits at f = infinity, where it can still
+            // be evicted once it has no children left.
+            nodes[current].total_weight = nodes[current].forgotten;
+            enqueue(current);
+        }
+        return result;
+    }
+};
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "expansion-trace.hpp"
+#include "map-io.hpp"
+
+// Events of one search: from a TRACE_BEGIN up to the next one on the
+// same thread.
+struct TracedSearch {
+    std::uint32_t thread;
+    std::vector<TraceEvent> events;
+};
+
+std::vector<TracedSearch> split_searches(const std::string& path, std::uint64_t& dropped) {
+    std::vector<TracedSearch> searches;
+    std::vector<int> open_search;   // per thread, index into searches or -1
+    dropped = read_trace(path, [&](std::uint32_t thread, const TraceEvent& event) {
+        if (open_search.size() <= thread) {
+            open_search.resize(thread + 1, -1);
+        }
+        if (event.kind == TRACE_BEGIN || open_search[thread] == -1) {
+            open_search[thread] = static_cast<int>(searches.size());
+            searches.push_back({thread, {}});
+        }
+        searches[open_search[thread]].events.push_back(event);
+    });
+    return searches;
+}
+
+void print_events(const std::vector<TracedSearch>& searches) {
+    for (const auto& search : searches) {
+        for (const TraceEvent& event : search.events) {
+            std::cout << "thread " << search.thread << " " << trace_kind_name(event.kind) << " (" << event.row
+                      << "," << event.col << ") " << event.weight << std::endl;
+        }
+    }
+}
+
+void print_summary(const std::vector<TracedSearch>& searches, std::uint64_t dropped) {
+    std::uint64_t totals[TRACE_KIND_COUNT + 1] = {};
+    for (std::size_t i = 0; i < searches.size(); i++) {
+        std::uint64_t counts[TRACE_KIND_COUNT + 1] = {};
+        for (const TraceEvent& event : searches[i].events) {
+            counts[std::min<int>(event.kind, TRACE_KIND_COUNT)]++;
+        }
+        const TraceEvent& first = searches[i].events.front();
+        std::cout << "search " << i << " (thread " << searches[i].thread << ", from " << first.row << ","
+                  << first.col << "):";
+        for (int kind = TRACE_POP; kind < TRACE_KIND_COUNT; kind++) {
+            std::cout << " " << counts[kind] << " " << trace_kind_name(kind);
+            totals[kind] += counts[kind];
+        }
+        std::cout << std::endl;
+    }
+    std::cout << searches.size() << " searches,";
+    for (int kind = TRACE_POP; kind < TRACE_KIND_COUNT; kind++) {
+        std::cout << " " << totals[kind] << " " << trace_kind_name(kind);
+    }
+    std::cout << ", " << dropped << " events dropped" << std::endl;
+}
+
+// One character per cell: S start, * on the reconstructed path, o popped,
+// + pushed but never popped, # wall (with a map), . untouched.
+void print_maps(const std::vector<TracedSearch>& searches, const std::vector<std::vector<int>>& data_matrix) {
+    for (std::size_t i = 0; i < searches.size(); i++) {
+        int rows = static_cast<int>(data_matrix.size());
+        int cols = data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size());
+        for (const TraceEvent& event : searches[i].events) {
+            rows = std::max(rows, event.row + 1);
+            cols = std::max(cols, event.col + 1);
+        }
+        std::vector<std::string> picture(rows, std::string(cols, '.'));
+        for (int r = 0; r < static_cast<int>(data_matrix.size()); r++) {
+            for (int c = 0; c < static_cast<int>(data_matrix[r].size()); c++) {
+                if (data_matrix[r][c] == -1) {
+                    picture[r][c] = '#';
+                }
+            }
+        }
+        auto rank = [](char cell) {
+            return std::string(".+o*S").find(cell);
+        };
+        for (const TraceEvent& event : searches[i].events) {
+            if (event.row < 0 || event.col < 0) {
+                continue;
+            }
+            char mark = event.kind == TRACE_BEGIN ? 'S'
+                      : event.kind == TRACE_RECONSTRUCT ? '*'
+                      : event.kind == TRACE_POP ? 'o' : '+';
+            char& cell = picture[event.row][event.col];
+            if (cell == '#' || rank(mark) > rank(cell)) {
+                cell = mark;
+            }
+        }
+        std::cout << "search " << i << " (thread " << searches[i].thread << ")" << std::endl;
+        for (const auto& line : picture) {
+            std::cout << line << std::endl;
+        }
+    }
+}
+
+// Decodes a trace written through TraceWriter (misleading-names --trace):
+// trace-decode TRACE [--summary | --events | --map [MAP]].
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " TRACE [--summary | --events | --map [MAP]]" << std::endl;
+        return 2;
+    }
+    std::string mode = argc > 2 ? argv[2] : "--summary";
+    try {
+        std::uint64_t dropped = 0;
+        auto searches = split_searches(argv[1], dropped);
+        if (mode == "--events") {
+            print_events(searches);
+        } else if (mode == "--map") {
+            print_maps(searches, argc > 3 ? load_grid_text(argv[3]) : std::vector<std::vector<int>>());
+        } else if (mode == "--summary") {
+            print_summary(searches, dropped);
+        } else {
+            std::cerr << "unknown mode " << mode << std::endl;
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
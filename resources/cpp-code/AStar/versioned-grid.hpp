@@ -0,0 +1,315 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+// One immutable version of a grid, split into square tiles of 2^tile_shift
+// cells per side. Versions share every tile they did not change, so a
+// snapshot is a table of tile pointers plus the tiles it owns a share of.
+// Satisfies the graph concept with the same node ids, edge order and
+// heuristic as GridGraph.
+class GridSnapshot {
+private:
+    friend class VersionedGrid;
+
+    int rows;
+    int cols;
+    int tile_shift;
+    int tile_mask;
+    int tiles_per_row;
+    std::uint64_t number;
+    std::vector<std::shared_ptr<const std::vector<int>>> owners;
+    std::vector<const int*> tiles;
+
+    int tile_of(int r, int c) const {
+        return (r >> tile_shift) * tiles_per_row + (c >> tile_shift);
+    }
+
+    int offset_of(int r, int c) const {
+        return ((r & tile_mask) << tile_shift) | (c & tile_mask);
+    }
+
+    int at(int r, int c) const {
+        return tiles[tile_of(r, c)][offset_of(r, c)];
+    }
+
+public:
+    std::uint64_t version() const {
+        return number;
+    }
+
+    int node_count() const {
+        return rows * cols;
+    }
+
+    int row_count() const {
+        return rows;
+    }
+
+    int column_count() const {
+        return cols;
+    }
+
+    int node(int r, int c) const {
+        return r * cols + c;
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        return {node / cols, node % cols};
+    }
+
+    int cost(int node) const {
+        return at(node / cols, node % cols);
+    }
+
+    bool passable(int node) const {
+        return cost(node) != -1;
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        int r = node / cols;
+        int c = node % cols;
+        int v;
+        if (r + 1 < rows && (v = at(r + 1, c)) != -1) {
+            visit(node + cols, static_cast<float>(v));
+        }
+        if (c + 1 < cols && (v = at(r, c + 1)) != -1) {
+            visit(node + 1, static_cast<float>(v));
+        }
+        if (r > 0 && (v = at(r - 1, c)) != -1) {
+            visit(node - cols, static_cast<float>(v));
+        }
+        if (c > 0 && (v = at(r, c - 1)) != -1) {
+            visit(node - 1, static_cast<float>(v));
+        }
+    }
+
+    float heuristic(int node, int target) const {
+        return static_cast<float>(std::abs(node / cols - target / cols) + std::abs(node % cols - target % cols));
+    }
+};
+
+struct CellUpdate {
+    int row;
+    int col;
+    int cost;   // -1 makes the cell a wall
+};
+
+// A grid that is edited while searches read it (RCU). Readers pin the
+// current GridSnapshot and search it without locks; the snapshot stays
+// valid until they unpin. A writer copies only the tiles its updates touch,
+// publishes the new version with one atomic pointer swap, and retires the
+// old one. Retired versions are freed by epoch-based reclamation once no
+// reader pinned before the swap is still active.
+//
+// Each reading thread owns one of `reader_slots` slots and passes its
+// index to pin(); a slot holds the epoch its reader pinned at, or idle.
+// Writers are serialized among themselves but never wait for readers.
+class VersionedGrid {
+private:
+    static constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<std::uint64_t> epoch{idle};
+    };
+
+    struct Retired {
+        std::uint64_t epoch;
+        const GridSnapshot* snapshot;
+    };
+
+    std::atomic<const GridSnapshot*> current;
+    std::atomic<std::uint64_t> global_epoch;
+    std::unique_ptr<ReaderSlot[]> slots;
+    int slot_count;
+    std::mutex writer_lock;
+    std::vector<Retired> retired;
+
+    // Frees every retired version that all active readers pinned after.
+    // Called with writer_lock held.
+    void reclaim_locked() {
+        std::uint64_t oldest = idle;
+        for (int i = 0; i < slot_count; i++) {
+            oldest = std::min(oldest, slots[i].epoch.load(std::memory_order_seq_cst));
+        }
+        auto kept = std::remove_if(retired.begin(), retired.end(), [&](const Retired& entry) {
+            if (entry.epoch < oldest) {
+                delete entry.snapshot;
+                return true;
+            }
+            return false;
+        });
+        retired.erase(kept, retired.end());
+    }
+
+public:
+    // Readers' view of one pinned version; unpins when destroyed.
+    class Pin {
+    private:
+        ReaderSlot* slot;
+        const GridSnapshot* pinned;
+
+    public:
+        Pin(ReaderSlot* slot_, const GridSnapshot* pinned_) : slot(slot_), pinned(pinned_) {}
+
+        Pin(Pin&& other) noexcept : slot(other.slot), pinned(other.pinned) {
+            other.slot = nullptr;
+        }
+
+        Pin(const Pin&) = delete;
+        Pin& operator=(const Pin&) = delete;
+        Pin& operator=(Pin&&) = delete;
+
+        ~Pin() {
+            if (slot != nullptr) {
+                slot->epoch.store(idle, std::memory_order_release);
+            }
+        }
+
+        const GridSnapshot& snapshot() const {
+            return *pinned;
+        }
+    };
+
+    VersionedGrid(const std::vector<std::vector<int>>& data_matrix, int reader_slots, int tile_shift = 5)
+        : global_epoch(0), slots(new ReaderSlot[reader_slots > 0 ? reader_slots : 1]),
+          slot_count(reader_slots > 0 ? reader_slots : 1) {
+        if (tile_shift < 0 || tile_shift > 12) {
+            throw std::invalid_argument("VersionedGrid: tile_shift must be between 0 and 12");
+        }
+        auto first = new GridSnapshot();
+        first->rows = static_cast<int>(data_matrix.size());
+        first->cols = data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size());
+        first->tile_shift = tile_shift;
+        first->tile_mask = (1 << tile_shift) - 1;
+        first->tiles_per_row = (first->cols + first->tile_mask) >> tile_shift;
+        first->number = 0;
+        int tile_rows = (first->rows + first->tile_mask) >> tile_shift;
+        std::vector<std::vector<int>> cells(static_cast<std::size_t>(tile_rows) * first->tiles_per_row,
+                                            std::vector<int>(std::size_t(1) << (2 * tile_shift), -1));
+        for (int r = 0; r < first->rows; r++) {
+            for (int c = 0; c < first->cols; c++) {
+                cells[first->tile_of(r, c)][first->offset_of(r, c)] = data_matrix[r][c];
+            }
+        }
+        for (auto& tile : cells) {
+            first->owners.push_back(std::make_shared<const std::vector<int>>(std::move(tile)));
+            first->tiles.push_back(first->owners.back()->data());
+        }
+        current.store(first, std::memory_order_release);
+    }
+
+    VersionedGrid(const VersionedGrid&) = delete;
+    VersionedGrid& operator=(const VersionedGrid&) = delete;
+
+    // Assumes no reader is still pinned.
+    ~VersionedGrid() {
+        for (const auto& entry : retired) {
+            delete entry.snapshot;
+        }
+        delete current.load(std::memory_order_acquire);
+    }
+
+    // Announces the reader in slot `reader` and returns the version that is
+    // current right after; the slot must not already be pinned.
+    Pin pin(int reader) {
+        if (reader < 0 || reader >= slot_count) {
+            throw std::invalid_argument("VersionedGrid::pin: no such reader slot");
+        }
+        ReaderSlot& slot = slots[reader];
+        slot.epoch.store(global_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return Pin(&slot, current.load(std::memory_order_seq_cst));
+    }
+
+    // Publishes a version with `updates` applied and returns its number.
+    // Each touched tile is copied once, however many of its cells change.
+    std::uint64_t update(const std::vector<CellUpdate>& updates) {
+        std::lock_guard<std::mutex> guard(writer_lock);
+        const GridSnapshot* old = current.load(std::memory_order_acquire);
+        for (const auto& u : updates) {
+            if (u.row < 0 || u.row >= old->rows || u.col < 0 || u.col >= old->cols || u.cost < -1) {
+                throw std::invalid_argument("VersionedGrid::update: cell outside the map or cost below -1");
+            }
+        }
+        auto next = new GridSnapshot(*old);
+        next->number = old->number + 1;
+        std::vector<std::vector<int>*> copies(next->tiles.size(), nullptr);
+        std::vector<std::shared_ptr<std::vector<int>>> fresh;
+        for (const auto& u : updates) {
+            int tile = next->tile_of(u.row, u.col);
+            if (copies[tile] == nullptr) {
+                fresh.push_back(std::make_shared<std::vector<int>>(*old->owners[tile]));
+                copies[tile] = fresh.back().get();
+                next->owners[tile] = fresh.back();
+                next->tiles[tile] = copies[tile]->data();
+            }
+            (*copies[tile])[next->offset_of(u.row, u.col)] = u.cost;
+        }
+        current.store(next, std::memory_order_seq_cst);
+        retired.push_back({global_epoch.fetch_add(1, std::memory_order_seq_cst), old});
+        reclaim_locked();
+        return next->number;
+    }
+
+    std::uint64_t set_cell(int r, int c, int cost) {
+        return update({{r, c, cost}});
+    }
+
+    void reclaim() {
+        std::lock_guard<std::mutex> guard(writer_lock);
+        reclaim_locked();
+    }
+
+    // Versions retired but not yet freed.
+    std::size_t retired_count() {
+        std::lock_guard<std::mutex> guard(writer_lock);
+        return retired.size();
+    }
+
+    std::uint64_t version() const {
+        return current.load(std::memory_order_acquire)->number;
+    }
+};
+
+// Graph concept over whichever snapshot it is pointed at, so one SearchCore
+// can be reused across versions (they all have the same dimensions). The
+// node count is kept apart, so the snapshot only has to stay pinned while
+// a search runs.
+class SnapshotGraph {
+private:
+    const GridSnapshot* snapshot;
+    int nodes;
+
+public:
+    explicit SnapshotGraph(const GridSnapshot& snapshot_) : snapshot(&snapshot_), nodes(snapshot_.node_count()) {}
+
+    void set_snapshot(const GridSnapshot& snapshot_) {
+        snapshot = &snapshot_;
+    }
+
+    const GridSnapshot& get() const {
+        return *snapshot;
+    }
+
+    int node_count() const {
+        return nodes;
+    }
+
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        snapshot->for_each_edge(node, visit);
+    }
+
+    float heuristic(int node, int target) const {
+        return snapshot->heuristic(node, target);
+    }
+};
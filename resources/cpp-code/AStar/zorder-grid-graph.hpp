@@ -0,0 +1,154 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Spreads the low 16 bits of v to the even bit positions.
+inline std::uint32_t spread_bits(std::uint32_t v) {
+#if defined(__BMI2__)
+    return _pdep_u32(v, 0x55555555u);
+#else
+    v &= 0x0000ffffu;
+    v = (v | (v << 8)) & 0x00ff00ffu;
+    v = (v | (v << 4)) & 0x0f0f0f0fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+#endif
+}
+
+// Inverse of spread_bits(): gathers the even bit positions of v.
+inline std::uint32_t gather_bits(std::uint32_t v) {
+#if defined(__BMI2__)
+    return _pext_u32(v, 0x55555555u);
+#else
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0f0f0f0fu;
+    v = (v | (v >> 4)) & 0x00ff00ffu;
+    v = (v | (v >> 8)) & 0x0000ffffu;
+    return v;
+#endif
+}
+
+inline std::uint32_t morton_encode(std::uint32_t r, std::uint32_t c) {
+    return (spread_bits(r) << 1) | spread_bits(c);
+}
+
+// Grid graph with cells stored in square tiles of 2^tile_shift cells per
+// side. Tiles are laid out row-major and cells inside a tile follow Morton
+// (Z) order, so a cell's vertical neighbors are usually in the same tile
+// instead of a full row away. Node ids are positions in that layout, which
+// puts SearchCore's per-node scratch arrays in the same order. Ragged
+// tiles at the right and bottom edges are padded with walls.
+class ZOrderGridGraph {
+private:
+    int rows;
+    int cols;
+    int tile_shift;
+    int tile_mask;
+    int tiles_per_row;
+    std::vector<int> costs;
+
+public:
+    explicit ZOrderGridGraph(const std::vector<std::vector<int>>& data_matrix, int tile_shift_ = 4)
+        : rows(static_cast<int>(data_matrix.size())),
+          cols(data_matrix.empty() ? 0 : static_cast<int>(data_matrix[0].size())),
+          tile_shift(tile_shift_), tile_mask((1 << tile_shift_) - 1) {
+        tiles_per_row = (cols + tile_mask) >> tile_shift;
+        int tile_rows = (rows + tile_mask) >> tile_shift;
+        costs.assign(static_cast<size_t>(tile_rows) * tiles_per_row << (2 * tile_shift), -1);
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                costs[node(r, c)] = data_matrix[r][c];
+            }
+        }
+    }
+
+    int node_count() const {
+        return static_cast<int>(costs.size());
+    }
+
+    int row_count() const {
+        return rows;
+    }
+
+    int column_count() const {
+        return cols;
+    }
+
+    int node(int r, int c) const {
+        int tile = (r >> tile_shift) * tiles_per_row + (c >> tile_shift);
+        return (tile << (2 * tile_shift)) | static_cast<int>(morton_encode(r & tile_mask, c & tile_mask));
+    }
+
+    std::pair<int, int> coordinates(int node) const {
+        int tile = node >> (2 * tile_shift);
+        std::uint32_t inner = static_cast<std::uint32_t>(node & ((1 << (2 * tile_shift)) - 1));
+        int r = ((tile / tiles_per_row) << tile_shift) | static_cast<int>(gather_bits(inner >> 1));
+        int c = ((tile % tiles_per_row) << tile_shift) | static_cast<int>(gather_bits(inner));
+        return {r, c};
+    }
+
+    int cost(int node) const {
+        return costs[node];
+    }
+
+    bool passable(int node) const {
+        return costs[node] != -1;
+    }
+
+    // Neighbors inside the tile are found with dilated-integer arithmetic on
+    // the Morton bits; only moves that leave the tile touch the tile index.
+    template <class Visit>
+    void for_each_edge(int node, Visit&& visit) const {
+        const int inner_bits = 2 * tile_shift;
+        const int inner_mask = (1 << inner_bits) - 1;
+        const int col_bits = static_cast<int>(0x55555555u & static_cast<std::uint32_t>(inner_mask));
+        const int row_bits = inner_mask ^ col_bits;
+        const int tile = node >> inner_bits;
+        const int base = tile << inner_bits;
+        const int inner = node & inner_mask;
+        const int r_part = inner & row_bits;
+        const int c_part = inner & col_bits;
+
+        auto try_visit = [&](int next) {
+            if (costs[next] != -1) {
+                visit(next, static_cast<float>(costs[next]));
+            }
+        };
+
+        if (r_part != row_bits) {
+            try_visit(base | (((r_part | col_bits) + 2) & row_bits) | c_part);
+        } else if (tile + tiles_per_row < node_count() >> inner_bits) {
+            try_visit(((tile + tiles_per_row) << inner_bits) | c_part);
+        }
+        if (c_part != col_bits) {
+            try_visit(base | r_part | (((c_part | row_bits) + 1) & col_bits));
+        } else if ((tile + 1) % tiles_per_row != 0) {
+            try_visit(((tile + 1) << inner_bits) | r_part);
+        }
+        if (r_part != 0) {
+            try_visit(base | ((r_part - 2) & row_bits) | c_part);
+        } else if (tile >= tiles_per_row) {
+            try_visit(((tile - tiles_per_row) << inner_bits) | row_bits | c_part);
+        }
+        if (c_part != 0) {
+            try_visit(base | r_part | ((c_part - 1) & col_bits));
+        } else if (tile % tiles_per_row != 0) {
+            try_visit(((tile - 1) << inner_bits) | r_part | col_bits);
+        }
+    }
+
+    float heuristic(int node, int target) const {
+        auto a = coordinates(node);
+        auto b = coordinates(target);
+        return static_cast<float>(std::abs(a.first - b.first) + std::abs(a.second - b.second));
+    }
+};